@@ -10,17 +10,31 @@
 
 #pragma once
 
+#include <string.h>
+
 struct k_work_q *zmk_display_work_q(void);
 
 bool zmk_display_is_initialized(void);
 int zmk_display_init(void);
 
+/**
+ * @brief Request a render after changing the UI.
+ *
+ * With CONFIG_ZMK_DISPLAY_ON_DEMAND_RENDER, the display is only refreshed when requested and while
+ * LVGL animations are running. Widgets using ZMK_DISPLAY_WIDGET_LISTENER request a render after
+ * each update automatically. Does nothing in the default periodic render mode.
+ */
+void zmk_display_request_render(void);
+
 /**
  * @brief Macro to define a ZMK event listener that handles the thread safety of fetching
  * the necessary state from the system work queue context, invoking a work callback
  * in the display queue context, and properly accessing that state safely when performing
  * display/LVGL updates.
  *
+ * Events arriving before the pending work runs are coalesced into a single update with the latest
+ * state.
+ *
  * @param listener THe ZMK Event manager listener name.
  * @param state_type The struct/enum type used to store/transfer state.
  * @param cb The callback to invoke in the display queue context to update the UI. Should be `void
@@ -31,6 +45,24 @@ int zmk_display_init(void);
  * widget once ready to be updated.
  **/
 #define ZMK_DISPLAY_WIDGET_LISTENER(listener, state_type, cb, state_func)                          \
+    static bool listener##_state_never_eq(const state_type *a, const state_type *b) {              \
+        return false;                                                                              \
+    }                                                                                              \
+    ZMK_DISPLAY_WIDGET_LISTENER_EQ(listener, state_type, cb, state_func,                           \
+                                   listener##_state_never_eq)
+
+/**
+ * @brief Like ZMK_DISPLAY_WIDGET_LISTENER, but skips updates that don't change the state.
+ *
+ * The last state passed to the work callback is cached, and the callback is skipped when
+ * @p eq_func finds the new state equal to it, so repeated events that don't change anything
+ * visible don't touch LVGL. Newly initialized widget instances are always updated. The state must
+ * hold everything the widget displays by value, not pointers to data that can change in place.
+ *
+ * @param eq_func The function comparing two states. Should be `bool func(const state_type *a, const
+ * state_type *b)` signature.
+ **/
+#define ZMK_DISPLAY_WIDGET_LISTENER_EQ(listener, state_type, cb, state_func, eq_func)              \
     K_MUTEX_DEFINE(listener##_mutex);                                                              \
     static state_type __##listener##_state;                                                        \
     static state_type listener##_get_local_state() {                                               \
@@ -39,7 +71,18 @@ int zmk_display_init(void);
         k_mutex_unlock(&listener##_mutex);                                                         \
         return copy;                                                                               \
     };                                                                                             \
-    static void listener##_work_cb(struct k_work *work) { cb(listener##_get_local_state()); };     \
+    static state_type listener##_rendered_state;                                                   \
+    static bool listener##_rendered_valid;                                                         \
+    static void listener##_work_cb(struct k_work *work) {                                          \
+        state_type state = listener##_get_local_state();                                           \
+        if (listener##_rendered_valid && eq_func(&state, &listener##_rendered_state)) {            \
+            return;                                                                                \
+        }                                                                                          \
+        cb(state);                                                                                 \
+        listener##_rendered_state = state;                                                         \
+        listener##_rendered_valid = true;                                                          \
+        zmk_display_request_render();                                                              \
+    };                                                                                             \
     K_WORK_DEFINE(listener##_work, listener##_work_cb);                                            \
     static void listener##_refresh_state(const zmk_event_t *eh) {                                  \
         k_mutex_lock(&listener##_mutex, K_FOREVER);                                                \
@@ -48,6 +91,7 @@ int zmk_display_init(void);
     };                                                                                             \
     static void listener##_init() {                                                                \
         listener##_refresh_state(NULL);                                                            \
+        listener##_rendered_valid = false;                                                         \
         listener##_work_cb(NULL);                                                                  \
     }                                                                                              \
     static int listener##_cb(const zmk_event_t *eh) {                                              \
@@ -44,8 +44,23 @@ int zmk_keymap_layer_toggle(zmk_keymap_layer_id_t layer);
 int zmk_keymap_layer_to(zmk_keymap_layer_id_t layer);
 const char *zmk_keymap_layer_name(zmk_keymap_layer_id_t layer);
 
+#if !IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS) &&                                              \
+    !IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+/**
+ * Not available with CONFIG_ZMK_KEYMAP_PACKED_BINDINGS or CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS,
+ * which don't keep every binding in RAM to point to. Use zmk_keymap_get_layer_binding_copy()
+ * instead.
+ */
 const struct zmk_behavior_binding *zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer,
                                                                        uint8_t binding_idx);
+#endif
+
+/**
+ * @brief Copy the binding at @p binding_idx of @p layer into @p binding. Safe to use while the
+ * keymap is changed from another thread.
+ */
+int zmk_keymap_get_layer_binding_copy(zmk_keymap_layer_id_t layer, uint8_t binding_idx,
+                                      struct zmk_behavior_binding *binding);
 int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer, uint8_t binding_idx,
                                         const struct zmk_behavior_binding binding);
 
@@ -23,6 +23,13 @@ struct zmk_periph_led {
     zmk_hid_indicators_t indicators;
     uint8_t effect;
     bool on;
+    struct zmk_led_hsb color;
+    uint8_t speed;
+    // Milliseconds elapsed on the central's effect clock
+    uint32_t clock;
+    // Whether color, speed and clock are set. Centrals running older firmware only send the
+    // fields before them.
+    bool has_effect_params;
 };
 
 int zmk_rgb_underglow_toggle(void);
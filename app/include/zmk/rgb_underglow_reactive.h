@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum zmk_rgb_underglow_reactive_mode {
+    ZMK_RGB_UNDERGLOW_REACTIVE_FADE,
+    ZMK_RGB_UNDERGLOW_REACTIVE_RIPPLE,
+    ZMK_RGB_UNDERGLOW_REACTIVE_HEATMAP,
+};
+
+/**
+ * Called for every pixel whose level changed during an update. A level of 0 means the pixel has
+ * finished animating and should be returned to its resting color.
+ */
+typedef void (*zmk_rgb_underglow_reactive_pixel_cb)(size_t pixel, uint8_t level);
+
+/**
+ * @brief Queue a key press at a position of the selected physical layout.
+ *
+ * Safe to call from any thread, the press is applied on the next update.
+ */
+int zmk_rgb_underglow_reactive_press(uint32_t position);
+
+/**
+ * @brief Rebuild the pixel geometry tables, e.g. after a different physical layout is selected.
+ */
+void zmk_rgb_underglow_reactive_layout_changed(void);
+
+/**
+ * @brief Stop all animations and drop any queued key presses.
+ */
+void zmk_rgb_underglow_reactive_reset(void);
+
+/**
+ * @brief Advance the animation to @p now, reporting changed pixels through @p cb.
+ *
+ * Only pixels which are still animating are visited, so the cost scales with the number of recently
+ * pressed keys rather than the length of the strip.
+ *
+ * @retval true if some pixels are still animating and another update is needed.
+ */
+bool zmk_rgb_underglow_reactive_update(enum zmk_rgb_underglow_reactive_mode mode, int64_t now,
+                                       zmk_rgb_underglow_reactive_pixel_cb cb);
@@ -44,7 +44,16 @@ struct zmk_split_update_led_data {
     uint8_t indicators;
     uint8_t effect;
     bool on;
+    uint16_t hue;
+    uint8_t saturation;
+    uint8_t brightness;
+    uint8_t speed;
+    uint32_t clock;
 } __packed;
+
+// Size of the payload sent by centrals running firmware from before the color, speed and clock
+// were added
+#define ZMK_SPLIT_UPDATE_LED_DATA_LEGACY_SIZE offsetof(struct zmk_split_update_led_data, hue)
 #endif
 
 #if IS_ENABLED(CONFIG_ZMK_BACKLIGHT)
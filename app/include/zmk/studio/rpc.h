@@ -219,6 +219,16 @@ struct ring_buf *zmk_rpc_get_tx_buf(void);
 struct ring_buf *zmk_rpc_get_rx_buf(void);
 void zmk_rpc_rx_notify(void);
 
+/**
+ * @brief Wait for the RPC thread to consume data from the RX buffer.
+ *
+ * For transports which receive on a thread that can't drop data once the RX buffer is full.
+ *
+ * @retval 0 once some data was consumed.
+ * @retval -EAGAIN if @p timeout expired first.
+ */
+int zmk_rpc_rx_wait_for_space(k_timeout_t timeout);
+
 #define ZMK_RPC_TRANSPORT(name, _transport, _rx_start, _rx_stop, _tx_user_data, _tx_notify)        \
     STRUCT_SECTION_ITERABLE(zmk_rpc_transport, name) = {                                           \
         .transport = _transport,                                                                   \
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/sys/dlist.h>
+
+struct zmk_timer;
+
+typedef void (*zmk_timer_handler_t)(struct zmk_timer *timer);
+
+/**
+ * A deadline registered with the shared ZMK timer wheel.
+ *
+ * All timers are driven by a single kernel timeout, so scheduling and cancelling a timer doesn't
+ * touch the kernel timeout queue. Handlers run on the system work queue, and timers expiring at
+ * the same time are handled in one batch, in the order they were scheduled.
+ */
+struct zmk_timer {
+    sys_dnode_t node;
+    zmk_timer_handler_t handler;
+    int64_t deadline;
+    // Wheel slot holding the timer, or -1 once it has expired
+    int16_t slot;
+    bool pending;
+};
+
+#define ZMK_TIMER_INITIALIZER(_handler) {.handler = (_handler)}
+
+/**
+ * @brief Statically define and initialize a timer.
+ */
+#define ZMK_TIMER_DEFINE(name, handler) struct zmk_timer name = ZMK_TIMER_INITIALIZER(handler)
+
+void zmk_timer_init(struct zmk_timer *timer, zmk_timer_handler_t handler);
+
+/**
+ * @brief Run the timer's handler at @p deadline, in milliseconds of uptime.
+ *
+ * A timer which is already pending is moved to the new deadline. Deadlines in the past expire on
+ * the next pass of the wheel.
+ */
+void zmk_timer_schedule_at(struct zmk_timer *timer, int64_t deadline);
+
+/**
+ * @brief Run the timer's handler @p delay_ms milliseconds from now.
+ */
+void zmk_timer_schedule(struct zmk_timer *timer, int32_t delay_ms);
+
+/**
+ * @brief Stop a pending timer.
+ *
+ * @retval 0 if the timer is no longer pending.
+ * @retval -EINPROGRESS if the timer's handler is running on another thread.
+ */
+int zmk_timer_cancel(struct zmk_timer *timer);
+
+/**
+ * @brief Check whether a timer is scheduled or its handler is running.
+ */
+bool zmk_timer_is_pending(const struct zmk_timer *timer);
@@ -34,7 +34,7 @@ LOG_MODULE_REGISTER(il0323, CONFIG_DISPLAY_LOG_LEVEL);
 #define IL0323_PANEL_LAST_GATE (EPD_PANEL_HEIGHT - 1)
 #define IL0323_PANEL_FIRST_PAGE 0U
 #define IL0323_PANEL_LAST_PAGE (IL0323_NUMOF_PAGES - 1)
-#define IL0323_BUFFER_SIZE 1280
+#define IL0323_BUFFER_SIZE (IL0323_NUMOF_PAGES * EPD_PANEL_HEIGHT)
 
 struct il0323_cfg {
     struct gpio_dt_spec reset;
@@ -45,7 +45,15 @@ struct il0323_cfg {
 
 static uint8_t il0323_pwr[] = DT_INST_PROP(0, pwr);
 
-static uint8_t last_buffer[IL0323_BUFFER_SIZE];
+/* Contents of the panel, sent as the old data of each refresh and used to find changed areas */
+static uint8_t shadow_buffer[EPD_PANEL_HEIGHT][IL0323_NUMOF_PAGES];
+/* Frame being drawn, the shadow buffer plus any written windows */
+static uint8_t frame_buffer[EPD_PANEL_HEIGHT][IL0323_NUMOF_PAGES];
+/* Contiguous copy of a refresh window, as the controller expects it */
+static uint8_t window_buffer[IL0323_BUFFER_SIZE];
+#if CONFIG_IL0323_FULL_REFRESH_INTERVAL > 0
+static uint16_t partial_refreshes;
+#endif
 static bool blanking_on = true;
 static bool init_clear_done = false;
 
@@ -95,23 +103,102 @@ static int il0323_update_display(const struct device *dev) {
     return 0;
 }
 
-static int il0323_write(const struct device *dev, const uint16_t x, const uint16_t y,
-                        const struct display_buffer_descriptor *desc, const void *buf) {
+static int il0323_send_window(const struct device *dev, uint16_t first_page, uint16_t last_page,
+                              uint16_t first_row, uint16_t last_row, const uint8_t *buf,
+                              size_t row_stride, bool full) {
     const struct il0323_cfg *cfg = dev->config;
+    const size_t row_len = last_page - first_page + 1;
+    const size_t len = row_len * (last_row - first_row + 1);
+    uint8_t ptl[IL0323_PTL_REG_LENGTH] = {0};
+
+    il0323_busy_wait(cfg);
+
+    if (!full) {
+        /* Setup Partial Window and enable Partial Mode */
+        ptl[IL0323_PTL_HRST_IDX] = first_page * IL0323_PIXELS_PER_BYTE;
+        ptl[IL0323_PTL_HRED_IDX] = (last_page + 1) * IL0323_PIXELS_PER_BYTE - 1;
+        ptl[IL0323_PTL_VRST_IDX] = first_row;
+        ptl[IL0323_PTL_VRED_IDX] = last_row;
+        ptl[sizeof(ptl) - 1] = IL0323_PTL_PT_SCAN;
+        LOG_HEXDUMP_DBG(ptl, sizeof(ptl), "ptl");
+
+        if (il0323_write_cmd(cfg, IL0323_CMD_PIN, NULL, 0)) {
+            return -EIO;
+        }
+
+        if (il0323_write_cmd(cfg, IL0323_CMD_PTL, ptl, sizeof(ptl))) {
+            return -EIO;
+        }
+    } else {
+        /* Make sure the whole panel is refreshed, not the last partial window */
+        if (il0323_write_cmd(cfg, IL0323_CMD_POUT, NULL, 0)) {
+            return -EIO;
+        }
+    }
+
+    /*
+     * Old data, so the controller only drives the pixels that change. A full refresh sends the
+     * inverse of the new data instead, so every pixel goes through the whole waveform, which is
+     * what clears the ghosting.
+     */
+    for (uint16_t row = first_row; row <= last_row; row++) {
+        uint8_t *old = &window_buffer[(row - first_row) * row_len];
+
+        if (full) {
+            for (size_t i = 0; i < row_len; i++) {
+                old[i] = ~buf[row * row_stride + first_page + i];
+            }
+        } else {
+            memcpy(old, &shadow_buffer[row][first_page], row_len);
+        }
+    }
+
+    if (il0323_write_cmd(cfg, IL0323_CMD_DTM1, window_buffer, len)) {
+        return -EIO;
+    }
+
+    for (uint16_t row = first_row; row <= last_row; row++) {
+        memcpy(&window_buffer[(row - first_row) * row_len], &buf[row * row_stride + first_page],
+               row_len);
+        memcpy(&shadow_buffer[row][first_page], &buf[row * row_stride + first_page], row_len);
+    }
+
+    if (il0323_write_cmd(cfg, IL0323_CMD_DTM2, window_buffer, len)) {
+        return -EIO;
+    }
+
+    if (blanking_on == false) {
+        if (il0323_update_display(dev)) {
+            return -EIO;
+        }
+    }
+
+    /* Disable Partial Mode */
+    if (!full && il0323_write_cmd(cfg, IL0323_CMD_POUT, NULL, 0)) {
+        return -EIO;
+    }
+
+    return 0;
+}
+
+static int il0323_write_window(const struct device *dev, const uint16_t x, const uint16_t y,
+                               const struct display_buffer_descriptor *desc, const void *buf,
+                               bool force) {
     uint16_t x_end_idx = x + desc->width - 1;
     uint16_t y_end_idx = y + desc->height - 1;
-    uint8_t ptl[IL0323_PTL_REG_LENGTH] = {0};
     size_t buf_len;
 
     LOG_DBG("x %u, y %u, height %u, width %u, pitch %u", x, y, desc->height, desc->width,
             desc->pitch);
 
-    buf_len = MIN(desc->buf_size, desc->height * desc->width / IL0323_PIXELS_PER_BYTE);
+    buf_len = MIN(desc->buf_size, desc->height * desc->pitch / IL0323_PIXELS_PER_BYTE);
     __ASSERT(desc->width <= desc->pitch, "Pitch is smaller then width");
     __ASSERT(buf != NULL, "Buffer is not available");
     __ASSERT(buf_len != 0U, "Buffer of length zero");
     __ASSERT(!(desc->width % IL0323_PIXELS_PER_BYTE), "Buffer width not multiple of %d",
              IL0323_PIXELS_PER_BYTE);
+    __ASSERT(!(x % IL0323_PIXELS_PER_BYTE), "X position not multiple of %d",
+             IL0323_PIXELS_PER_BYTE);
 
     LOG_DBG("buf_len %d", buf_len);
     if ((y_end_idx > (EPD_PANEL_HEIGHT - 1)) || (x_end_idx > (EPD_PANEL_WIDTH - 1))) {
@@ -119,45 +206,64 @@ static int il0323_write(const struct device *dev, const uint16_t x, const uint16
         return -EINVAL;
     }
 
-    /* Setup Partial Window and enable Partial Mode */
-    ptl[IL0323_PTL_HRST_IDX] = x;
-    ptl[IL0323_PTL_HRED_IDX] = x_end_idx;
-    ptl[IL0323_PTL_VRST_IDX] = y;
-    ptl[IL0323_PTL_VRED_IDX] = y_end_idx;
-    ptl[sizeof(ptl) - 1] = IL0323_PTL_PT_SCAN;
-    LOG_HEXDUMP_DBG(ptl, sizeof(ptl), "ptl");
-
-    il0323_busy_wait(cfg);
-    if (il0323_write_cmd(cfg, IL0323_CMD_PIN, NULL, 0)) {
-        return -EIO;
+    if (buf_len < desc->height * desc->pitch / IL0323_PIXELS_PER_BYTE) {
+        LOG_ERR("Buffer too small for the window");
+        return -EINVAL;
     }
 
-    if (il0323_write_cmd(cfg, IL0323_CMD_PTL, ptl, sizeof(ptl))) {
-        return -EIO;
-    }
+    const uint8_t *src = buf;
+    const size_t src_stride = desc->pitch / IL0323_PIXELS_PER_BYTE;
+    const uint16_t first_page = x / IL0323_PIXELS_PER_BYTE;
+    const uint16_t pages = desc->width / IL0323_PIXELS_PER_BYTE;
 
-    if (il0323_write_cmd(cfg, IL0323_CMD_DTM1, last_buffer, IL0323_BUFFER_SIZE)) {
-        return -EIO;
+    /* Stage the window into a full frame so it can be compared with the panel contents */
+    for (uint16_t row = 0; row < desc->height; row++) {
+        memcpy(&frame_buffer[y + row][first_page], &src[row * src_stride], pages);
     }
 
-    if (il0323_write_cmd(cfg, IL0323_CMD_DTM2, (uint8_t *)buf, buf_len)) {
-        return -EIO;
-    }
+    /* Find the smallest rectangle of bytes that differs from what the panel shows */
+    uint16_t dirty_first_page = UINT16_MAX, dirty_last_page = 0;
+    uint16_t dirty_first_row = UINT16_MAX, dirty_last_row = 0;
 
-    memcpy(last_buffer, (uint8_t *)buf, IL0323_BUFFER_SIZE);
+    for (uint16_t row = y; row <= y_end_idx; row++) {
+        for (uint16_t page = first_page; page < first_page + pages; page++) {
+            if (!force && frame_buffer[row][page] == shadow_buffer[row][page]) {
+                continue;
+            }
 
-    /* Update partial window and disable Partial Mode */
-    if (blanking_on == false) {
-        if (il0323_update_display(dev)) {
-            return -EIO;
+            dirty_first_page = MIN(dirty_first_page, page);
+            dirty_last_page = MAX(dirty_last_page, page);
+            dirty_first_row = MIN(dirty_first_row, row);
+            dirty_last_row = MAX(dirty_last_row, row);
         }
     }
 
-    if (il0323_write_cmd(cfg, IL0323_CMD_POUT, NULL, 0)) {
-        return -EIO;
+    if (dirty_first_row == UINT16_MAX) {
+        LOG_DBG("Nothing changed, skipping refresh");
+        return 0;
     }
 
-    return 0;
+#if CONFIG_IL0323_FULL_REFRESH_INTERVAL > 0
+    /* Partial refreshes leave some ghosting behind, clear it with a full refresh now and then */
+    if (blanking_on == false && ++partial_refreshes >= CONFIG_IL0323_FULL_REFRESH_INTERVAL) {
+        partial_refreshes = 0;
+        LOG_DBG("Full refresh");
+        return il0323_send_window(dev, IL0323_PANEL_FIRST_PAGE, IL0323_PANEL_LAST_PAGE,
+                                  IL0323_PANEL_FIRST_GATE, IL0323_PANEL_LAST_GATE,
+                                  &frame_buffer[0][0], IL0323_NUMOF_PAGES, true);
+    }
+#endif
+
+    LOG_DBG("Dirty pages %u-%u, rows %u-%u", dirty_first_page, dirty_last_page, dirty_first_row,
+            dirty_last_row);
+
+    return il0323_send_window(dev, dirty_first_page, dirty_last_page, dirty_first_row,
+                              dirty_last_row, &frame_buffer[0][0], IL0323_NUMOF_PAGES, false);
+}
+
+static int il0323_write(const struct device *dev, const uint16_t x, const uint16_t y,
+                        const struct display_buffer_descriptor *desc, const void *buf) {
+    return il0323_write_window(dev, x, y, desc, buf, false);
 }
 
 static int il0323_read(const struct device *dev, const uint16_t x, const uint16_t y,
@@ -183,7 +289,7 @@ static int il0323_clear_and_write_buffer(const struct device *dev, uint8_t patte
 
     memset(line, pattern, IL0323_NUMOF_PAGES);
     for (int i = 0; i < EPD_PANEL_HEIGHT; i++) {
-        il0323_write(dev, 0, i, &desc, line);
+        il0323_write_window(dev, 0, i, &desc, line, true);
     }
 
     k_free(line);
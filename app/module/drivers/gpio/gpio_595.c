@@ -41,6 +41,8 @@ struct reg_595_drv_data {
     struct k_sem lock;
 
     uint32_t gpio_cache;
+    /* Whether gpio_cache matches what was last written to the registers */
+    bool cache_valid;
 };
 
 static int reg_595_write_registers(const struct device *dev, uint32_t value) {
@@ -69,6 +71,7 @@ static int reg_595_write_registers(const struct device *dev, uint32_t value) {
     }
 
     drv_data->gpio_cache = value;
+    drv_data->cache_valid = true;
     return 0;
 }
 
@@ -106,7 +109,12 @@ static int reg_595_port_set_masked_raw(const struct device *dev, uint32_t mask,
     buf = drv_data->gpio_cache;
     buf = (buf & ~mask) | (mask & value);
 
-    ret = reg_595_write_registers(dev, buf);
+    /* Skip the SPI transfer if the outputs would not change */
+    if (drv_data->cache_valid && buf == drv_data->gpio_cache) {
+        ret = 0;
+    } else {
+        ret = reg_595_write_registers(dev, buf);
+    }
 
     k_sem_give(&drv_data->lock);
     return ret;
@@ -17,6 +17,7 @@
 #include <zephyr/init.h>
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_utils.h>
 #include <zephyr/drivers/i2c.h>
 
 #define LOG_LEVEL CONFIG_GPIO_LOG_LEVEL
@@ -40,6 +41,9 @@ struct max7318_config {
 
     struct i2c_dt_spec i2c_bus;
     uint8_t ngpios;
+
+    // Optional host GPIO connected to the active-low INT output of the chip
+    struct gpio_dt_spec interrupt;
 };
 
 // Runtime driver data
@@ -54,6 +58,22 @@ struct max7318_drv_data {
         uint16_t config;
         uint16_t output;
     } reg_cache;
+
+    const struct device *dev;
+    sys_slist_t callbacks;
+    struct gpio_callback interrupt_callback;
+    struct k_work interrupt_work;
+
+    // Interrupt configuration, one bit per pin
+    struct {
+        uint16_t enabled;
+        uint16_t edge;
+        uint16_t high;
+        uint16_t low;
+        // Inputs as last seen by the interrupt work, to detect edges. Reads through the GPIO API
+        // don't update it, so a change they clear from INT is still seen as an edge.
+        uint16_t input;
+    } irq;
 };
 
 /**
@@ -114,6 +134,44 @@ static int write_registers(const struct device *dev, uint8_t reg, uint16_t value
     return i2c_burst_write_dt(&config->i2c_bus, reg, &data[0], sizeof(data));
 }
 
+/**
+ * @brief Update a pair of registers from their cached value
+ *
+ * Only the registers whose value changed are written, so updating a single port costs a one-byte
+ * write, and nothing is written if neither port changed.
+ *
+ * @param dev   The max7318 device.
+ * @param reg   Register to write (usually the register for PORT0).
+ * @param cache The cached value of the registers. Updated on success.
+ * @param value The value to write
+ *
+ * @return 0 if successful, failed otherwise.
+ */
+static int update_registers(const struct device *dev, uint8_t reg, uint16_t *cache,
+                            uint16_t value) {
+    const struct max7318_config *config = dev->config;
+    const uint16_t changed = *cache ^ value;
+    int ret = 0;
+
+    if ((changed & 0xFF00) == 0) {
+        if ((changed & 0x00FF) == 0) {
+            return 0;
+        }
+
+        ret = i2c_reg_write_byte_dt(&config->i2c_bus, reg, value & 0xFF);
+    } else if ((changed & 0x00FF) == 0) {
+        ret = i2c_reg_write_byte_dt(&config->i2c_bus, reg + 1, value >> 8);
+    } else {
+        ret = write_registers(dev, reg, value);
+    }
+
+    if (ret == 0) {
+        *cache = value;
+    }
+
+    return ret;
+}
+
 /**
  * @brief Setup the pin direction (input or output)
  *
@@ -125,8 +183,8 @@ static int write_registers(const struct device *dev, uint8_t reg, uint16_t value
  */
 static int set_pin_direction(const struct device *dev, uint32_t pin, int flags) {
     struct max7318_drv_data *const drv_data = (struct max7318_drv_data *const)dev->data;
-    uint16_t *dir = &drv_data->reg_cache.config;
-    uint16_t *output = &drv_data->reg_cache.output;
+    uint16_t dir = drv_data->reg_cache.config;
+    uint16_t output = drv_data->reg_cache.output;
 
     /*
         The output register is 1=high, 0=low; the direction (config) register
@@ -134,21 +192,21 @@ static int set_pin_direction(const struct device *dev, uint32_t pin, int flags)
     */
     if ((flags & GPIO_OUTPUT) != 0U) {
         if ((flags & GPIO_OUTPUT_INIT_HIGH) != 0U) {
-            *output |= BIT(pin);
+            output |= BIT(pin);
         } else if ((flags & GPIO_OUTPUT_INIT_LOW) != 0U) {
-            *output &= ~BIT(pin);
+            output &= ~BIT(pin);
         }
-        *dir &= ~BIT(pin);
+        dir &= ~BIT(pin);
     } else {
-        *dir |= BIT(pin);
+        dir |= BIT(pin);
     }
 
-    int ret = write_registers(dev, REG_OUTPUT_PORTA, *output);
+    int ret = update_registers(dev, REG_OUTPUT_PORTA, &drv_data->reg_cache.output, output);
     if (ret != 0) {
         return ret;
     }
 
-    return write_registers(dev, REG_CONFIG_PORTA, *dir);
+    return update_registers(dev, REG_CONFIG_PORTA, &drv_data->reg_cache.config, dir);
 }
 
 /**
@@ -215,6 +273,7 @@ static int max7318_port_get_raw(const struct device *dev, uint32_t *value) {
 
     k_sem_take(&drv_data->lock, K_FOREVER);
 
+    // Both ports are read in one transaction. This also clears the INT output.
     uint16_t buf = 0;
     int ret = read_registers(dev, REG_INPUT_PORTA, &buf);
     if (ret != 0) {
@@ -241,10 +300,7 @@ static int max7318_port_set_masked_raw(const struct device *dev, uint32_t mask,
     uint16_t buf = drv_data->reg_cache.output;
     buf = (buf & ~mask) | (mask & value);
 
-    int ret = write_registers(dev, REG_OUTPUT_PORTA, buf);
-    if (ret == 0) {
-        drv_data->reg_cache.output = buf;
-    }
+    int ret = update_registers(dev, REG_OUTPUT_PORTA, &drv_data->reg_cache.output, buf);
 
     k_sem_give(&drv_data->lock);
     return ret;
@@ -271,18 +327,126 @@ static int max7318_port_toggle_bits(const struct device *dev, uint32_t mask) {
     uint16_t buf = drv_data->reg_cache.output;
     buf ^= mask;
 
-    int ret = write_registers(dev, REG_OUTPUT_PORTA, buf);
+    int ret = update_registers(dev, REG_OUTPUT_PORTA, &drv_data->reg_cache.output, buf);
+
+    k_sem_give(&drv_data->lock);
+    return ret;
+}
+
+/**
+ * @brief Handle a change signalled on the INT output of the chip
+ *
+ * Reads both input ports, which also clears the INT output, and fires the callbacks for all pins
+ * whose interrupt condition is met.
+ */
+static void max7318_interrupt_work_handler(struct k_work *work) {
+    struct max7318_drv_data *const drv_data =
+        CONTAINER_OF(work, struct max7318_drv_data, interrupt_work);
+    const struct device *dev = drv_data->dev;
+
+    k_sem_take(&drv_data->lock, K_FOREVER);
+
+    const uint16_t prev = drv_data->irq.input;
+    uint16_t input = 0;
+    int ret = read_registers(dev, REG_INPUT_PORTA, &input);
     if (ret == 0) {
-        drv_data->reg_cache.output = buf;
+        drv_data->irq.input = input;
     }
 
+    const uint16_t triggered = (drv_data->irq.high & input) | (drv_data->irq.low & ~input);
+    const uint16_t edge = drv_data->irq.edge & (prev ^ input) & triggered;
+    const uint16_t level = ~drv_data->irq.edge & triggered;
+    const uint16_t fired = drv_data->irq.enabled & (edge | level);
+
     k_sem_give(&drv_data->lock);
-    return ret;
+
+    if (ret != 0) {
+        LOG_ERR("error reading inputs (%d)", ret);
+        return;
+    }
+
+    if (fired) {
+        gpio_fire_callbacks(&drv_data->callbacks, dev, fired);
+    }
+}
+
+static void max7318_interrupt_callback(const struct device *port, struct gpio_callback *cb,
+                                       gpio_port_pins_t pins) {
+    struct max7318_drv_data *const drv_data =
+        CONTAINER_OF(cb, struct max7318_drv_data, interrupt_callback);
+
+    // Can't do I2C bus operations from an ISR, so read the inputs from a work item.
+    k_work_submit(&drv_data->interrupt_work);
 }
 
 static int max7318_pin_interrupt_configure(const struct device *dev, gpio_pin_t pin,
                                            enum gpio_int_mode mode, enum gpio_int_trig trig) {
-    return -ENOTSUP;
+    const struct max7318_config *config = dev->config;
+    struct max7318_drv_data *const drv_data = (struct max7318_drv_data *const)dev->data;
+
+    if (!config->interrupt.port) {
+        return -ENOTSUP;
+    }
+
+    /* The interrupt work holds the lock across I2C transfers */
+    if (k_is_in_isr()) {
+        return -EWOULDBLOCK;
+    }
+
+    k_sem_take(&drv_data->lock, K_FOREVER);
+
+    WRITE_BIT(drv_data->irq.enabled, pin, mode != GPIO_INT_MODE_DISABLED);
+    WRITE_BIT(drv_data->irq.edge, pin, mode == GPIO_INT_MODE_EDGE);
+    WRITE_BIT(drv_data->irq.high, pin, (trig & GPIO_INT_TRIG_HIGH) != 0);
+    WRITE_BIT(drv_data->irq.low, pin, (trig & GPIO_INT_TRIG_LOW) != 0);
+
+    k_sem_give(&drv_data->lock);
+
+    // The pin may already be at the requested level, which the chip won't signal as a change.
+    if (mode == GPIO_INT_MODE_LEVEL) {
+        k_work_submit(&drv_data->interrupt_work);
+    }
+
+    return 0;
+}
+
+static int max7318_manage_callback(const struct device *dev, struct gpio_callback *callback,
+                                   bool set) {
+    struct max7318_drv_data *const drv_data = (struct max7318_drv_data *const)dev->data;
+
+    return gpio_manage_callback(&drv_data->callbacks, callback, set);
+}
+
+static int max7318_init_interrupt(const struct device *dev) {
+    const struct max7318_config *const config = dev->config;
+    struct max7318_drv_data *const drv_data = (struct max7318_drv_data *const)dev->data;
+
+    if (!gpio_is_ready_dt(&config->interrupt)) {
+        LOG_WRN("interrupt gpio not ready!");
+        return -ENODEV;
+    }
+
+    k_work_init(&drv_data->interrupt_work, max7318_interrupt_work_handler);
+
+    int ret = gpio_pin_configure_dt(&config->interrupt, GPIO_INPUT);
+    if (ret != 0) {
+        return ret;
+    }
+
+    gpio_init_callback(&drv_data->interrupt_callback, max7318_interrupt_callback,
+                       BIT(config->interrupt.pin));
+    ret = gpio_add_callback(config->interrupt.port, &drv_data->interrupt_callback);
+    if (ret != 0) {
+        return ret;
+    }
+
+    // Read the inputs once to clear any pending change and seed the last seen inputs.
+    ret = read_registers(dev, REG_INPUT_PORTA, &drv_data->irq.input);
+    if (ret != 0) {
+        return ret;
+    }
+
+    return gpio_pin_interrupt_configure_dt(&config->interrupt, GPIO_INT_EDGE_TO_ACTIVE);
 }
 
 static const struct gpio_driver_api api_table = {
@@ -293,6 +457,7 @@ static const struct gpio_driver_api api_table = {
     .port_clear_bits_raw = max7318_port_clear_bits_raw,
     .port_toggle_bits = max7318_port_toggle_bits,
     .pin_interrupt_configure = max7318_pin_interrupt_configure,
+    .manage_callback = max7318_manage_callback,
 };
 
 /**
@@ -312,7 +477,17 @@ static int max7318_init(const struct device *dev) {
 
     LOG_INF("device initialised at 0x%x", config->i2c_bus.addr);
 
+    drv_data->dev = dev;
     k_sem_init(&drv_data->lock, 1, 1);
+
+    if (config->interrupt.port) {
+        int ret = max7318_init_interrupt(dev);
+        if (ret != 0) {
+            LOG_ERR("error setting up interrupt (%d)", ret);
+            return ret;
+        }
+    }
+
     return 0;
 }
 
@@ -324,7 +499,8 @@ static int max7318_init(const struct device *dev) {
 #define MAX7318_INIT(inst)                                                                         \
     static const struct max7318_config max7318_##inst##_config = {                                 \
         .common = {.port_pin_mask = GPIO_PORT_PIN_MASK_FROM_DT_INST(inst)},                        \
-        .i2c_bus = I2C_DT_SPEC_INST_GET(inst)};                                                    \
+        .i2c_bus = I2C_DT_SPEC_INST_GET(inst),                                                     \
+        .interrupt = GPIO_DT_SPEC_INST_GET_OR(inst, interrupt_gpios, {0})};                        \
                                                                                                    \
     static struct max7318_drv_data max7318_##inst##_drvdata = {                                    \
         /* Default for registers according to datasheet */                                         \
@@ -7,9 +7,13 @@
 #define DT_DRV_COMPAT zmk_kscan_composite
 
 #include <zephyr/device.h>
+#include <zephyr/kernel.h>
 #include <zephyr/pm/device.h>
 #include <zephyr/drivers/kscan.h>
 #include <zephyr/logging/log.h>
+
+#include <zmk/kscan_batch.h>
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #define MATRIX_NODE_ID DT_DRV_INST(0)
@@ -34,6 +38,7 @@ struct kscan_composite_config {
 
 struct kscan_composite_data {
     kscan_callback_t callback;
+    zmk_kscan_batch_callback_t batch_callback;
 
     const struct device *dev;
 };
@@ -94,8 +99,9 @@ static int kscan_composite_disable_callback(const struct device *dev) {
 
 static const struct device *all_instances[] = {DT_INST_FOREACH_STATUS_OKAY(KSCAN_COMP_INST_DEV)};
 
-static void kscan_composite_child_callback(const struct device *child_dev, uint32_t row,
-                                           uint32_t column, bool pressed) {
+static void kscan_composite_child_batch_callback(const struct device *child_dev,
+                                                 const struct zmk_kscan_batch_event *events,
+                                                 size_t len, int64_t timestamp) {
     // TODO: Ideally we can get this passed into our callback!
     for (int i = 0; i < ARRAY_SIZE(all_instances); i++) {
 
@@ -110,27 +116,66 @@ static void kscan_composite_child_callback(const struct device *child_dev, uint3
                 continue;
             }
 
-            data->callback(dev, row + child_cfg->row_offset, column + child_cfg->column_offset,
-                           pressed);
+            struct zmk_kscan_batch batch;
+            zmk_kscan_batch_begin(&batch, dev, data->callback, data->batch_callback, timestamp);
+
+            for (size_t e = 0; e < len; e++) {
+                zmk_kscan_batch_report(&batch, events[e].row + child_cfg->row_offset,
+                                       events[e].column + child_cfg->column_offset,
+                                       events[e].pressed);
+            }
+
+            zmk_kscan_batch_end(&batch);
         }
     }
 }
 
-static int kscan_composite_configure(const struct device *dev, kscan_callback_t callback) {
+static void kscan_composite_child_callback(const struct device *child_dev, uint32_t row,
+                                           uint32_t column, bool pressed) {
+    const struct zmk_kscan_batch_event ev = {.row = row, .column = column, .pressed = pressed};
+
+    kscan_composite_child_batch_callback(child_dev, &ev, 1, k_uptime_get());
+}
+
+static void kscan_composite_configure_children(const struct device *dev) {
     const struct kscan_composite_config *cfg = dev->config;
+
+    for (int i = 0; i < cfg->children_len; i++) {
+        const struct kscan_composite_child_config *child_cfg = &cfg->children[i];
+
+        // Prefer batched callbacks so a whole scan pass of a child is forwarded at once.
+        if (zmk_kscan_batch_config(child_cfg->child, &kscan_composite_child_batch_callback) < 0) {
+            kscan_config(child_cfg->child, &kscan_composite_child_callback);
+        }
+    }
+}
+
+static int kscan_composite_configure(const struct device *dev, kscan_callback_t callback) {
     struct kscan_composite_data *data = dev->data;
 
     if (!callback) {
         return -EINVAL;
     }
 
-    for (int i = 0; i < cfg->children_len; i++) {
-        const struct kscan_composite_child_config *child_cfg = &cfg->children[i];
+    kscan_composite_configure_children(dev);
+
+    data->callback = callback;
+    data->batch_callback = NULL;
 
-        kscan_config(child_cfg->child, &kscan_composite_child_callback);
+    return 0;
+}
+
+static int kscan_composite_configure_batch(const struct device *dev,
+                                           zmk_kscan_batch_callback_t callback) {
+    struct kscan_composite_data *data = dev->data;
+
+    if (!callback) {
+        return -EINVAL;
     }
 
-    data->callback = callback;
+    kscan_composite_configure_children(dev);
+
+    data->batch_callback = callback;
 
     return 0;
 }
@@ -179,6 +224,8 @@ static int kscan_composite_pm_action(const struct device *dev, enum pm_device_ac
     PM_DEVICE_DT_INST_DEFINE(n, kscan_composite_pm_action);                                        \
     DEVICE_DT_INST_DEFINE(n, kscan_composite_init, PM_DEVICE_DT_INST_GET(n),                       \
                           &kscan_composite_data_##n, &kscan_composite_config_##n, POST_KERNEL,     \
-                          CONFIG_ZMK_KSCAN_COMPOSITE_INIT_PRIORITY, &mock_driver_api);
+                          CONFIG_ZMK_KSCAN_COMPOSITE_INIT_PRIORITY, &mock_driver_api);             \
+    ZMK_KSCAN_BATCH_DRIVER(kscan_composite_batch_##n, DEVICE_DT_INST_GET(n),                       \
+                           kscan_composite_configure_batch);
 
 DT_INST_FOREACH_STATUS_OKAY(KSCAN_COMP_DEV)
@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include "kscan_poll.h"
+
 #include <zmk/debounce.h>
+#include <zmk/kscan_batch.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -56,8 +59,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 struct kscan_charlieplex_data {
     const struct device *dev;
     kscan_callback_t callback;
+    zmk_kscan_batch_callback_t batch_callback;
     struct k_work_delayable work;
     int64_t scan_time; /* Timestamp of the current or scheduled scan. */
+    struct kscan_poll_state poll; /* Idle polling rate, if not using interrupts. */
     struct gpio_callback irq_callback;
     /**
      * Current state of the matrix as a flattened 2D array of length
@@ -226,6 +231,11 @@ static void kscan_charlieplex_read_continue(const struct device *dev) {
     const struct kscan_charlieplex_config *config = dev->config;
     struct kscan_charlieplex_data *data = dev->data;
 
+    if (!config->use_interrupt) {
+        // A key is active, so go back to the fastest idle polling rate once it is released.
+        kscan_poll_reset(&data->poll, config->poll_period_ms, data->scan_time);
+    }
+
     data->scan_time += config->debounce_scan_period_ms;
 
     k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
@@ -239,7 +249,8 @@ static void kscan_charlieplex_read_end(const struct device *dev) {
         // Return to waiting for an interrupt.
         kscan_charlieplex_interrupt_enable(dev);
     } else {
-        data->scan_time += config->poll_period_ms;
+        data->scan_time +=
+            kscan_poll_next_period(&data->poll, config->poll_period_ms, data->scan_time);
 
         // Return to polling slowly.
         k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
@@ -258,11 +269,15 @@ static int kscan_charlieplex_read(const struct device *dev) {
         return err;
     }
 
+    struct zmk_kscan_batch batch;
+    zmk_kscan_batch_begin(&batch, dev, data->callback, data->batch_callback, data->scan_time);
+
     // Scan the matrix.
     for (int row = 0; row < config->cells.len; row++) {
         const struct gpio_dt_spec *out_gpio = &config->cells.gpios[row];
         err = kscan_charlieplex_set_as_output(out_gpio);
         if (err) {
+            zmk_kscan_batch_end(&batch);
             return err;
         }
 
@@ -287,13 +302,14 @@ static int kscan_charlieplex_read(const struct device *dev) {
                 const bool pressed = zmk_debounce_is_pressed(state);
 
                 LOG_DBG("Sending event at %i,%i state %s", row, col, pressed ? "on" : "off");
-                data->callback(dev, row, col, pressed);
+                zmk_kscan_batch_report(&batch, row, col, pressed);
             }
             continue_scan = continue_scan || zmk_debounce_is_active(state);
         }
 
         err = kscan_charlieplex_set_as_input(out_gpio);
         if (err) {
+            zmk_kscan_batch_end(&batch);
             return err;
         }
 #if CONFIG_ZMK_KSCAN_CHARLIEPLEX_WAIT_BETWEEN_OUTPUTS > 0
@@ -301,6 +317,8 @@ static int kscan_charlieplex_read(const struct device *dev) {
 #endif
     }
 
+    zmk_kscan_batch_end(&batch);
+
     if (continue_scan) {
         // At least one key is pressed or the debouncer has not yet decided if
         // it is pressed. Poll quickly until everything is released.
@@ -326,6 +344,18 @@ static int kscan_charlieplex_configure(const struct device *dev, const kscan_cal
 
     struct kscan_charlieplex_data *data = dev->data;
     data->callback = callback;
+    data->batch_callback = NULL;
+    return 0;
+}
+
+static int kscan_charlieplex_configure_batch(const struct device *dev,
+                                             const zmk_kscan_batch_callback_t callback) {
+    if (!callback) {
+        return -EINVAL;
+    }
+
+    struct kscan_charlieplex_data *data = dev->data;
+    data->batch_callback = callback;
     return 0;
 }
 
@@ -333,6 +363,11 @@ static int kscan_charlieplex_enable(const struct device *dev) {
     struct kscan_charlieplex_data *data = dev->data;
     data->scan_time = k_uptime_get();
 
+    const struct kscan_charlieplex_config *config = dev->config;
+    if (!config->use_interrupt) {
+        kscan_poll_reset(&data->poll, config->poll_period_ms, data->scan_time);
+    }
+
     // Read will automatically start interrupts/polling once done.
     return kscan_charlieplex_read(dev);
 }
@@ -465,6 +500,9 @@ static const struct kscan_driver_api kscan_charlieplex_api = {
                                                                                                    \
     DEVICE_DT_INST_DEFINE(n, &kscan_charlieplex_init, PM_DEVICE_DT_INST_GET(n),                    \
                           &kscan_charlieplex_data_##n, &kscan_charlieplex_config_##n, POST_KERNEL, \
-                          CONFIG_KSCAN_INIT_PRIORITY, &kscan_charlieplex_api);
+                          CONFIG_KSCAN_INIT_PRIORITY, &kscan_charlieplex_api);                     \
+                                                                                                   \
+    ZMK_KSCAN_BATCH_DRIVER(kscan_charlieplex_batch_##n, DEVICE_DT_INST_GET(n),                     \
+                           kscan_charlieplex_configure_batch);
 
 DT_INST_FOREACH_STATUS_OKAY(KSCAN_CHARLIEPLEX_INIT);
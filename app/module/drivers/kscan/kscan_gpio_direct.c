@@ -5,6 +5,7 @@
  */
 
 #include "kscan_gpio.h"
+#include "kscan_poll.h"
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -16,6 +17,7 @@
 #include <zephyr/sys/util.h>
 
 #include <zmk/debounce.h>
+#include <zmk/kscan_batch.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -60,10 +62,14 @@ struct kscan_direct_data {
     const struct device *dev;
     struct kscan_gpio_list inputs;
     kscan_callback_t callback;
+    zmk_kscan_batch_callback_t batch_callback;
     struct k_work_delayable work;
 #if USE_INTERRUPTS
     /** Array of length config->inputs.len */
     struct kscan_direct_irq_callback *irqs;
+#endif
+#if USE_POLLING
+    struct kscan_poll_state poll;
 #endif
     /** Timestamp of the current or scheduled scan. */
     int64_t scan_time;
@@ -153,6 +159,11 @@ static void kscan_direct_read_continue(const struct device *dev) {
     const struct kscan_direct_config *config = dev->config;
     struct kscan_direct_data *data = dev->data;
 
+#if USE_POLLING
+    // A key is active, so go back to the fastest idle polling rate once it is released.
+    kscan_poll_reset(&data->poll, config->poll_period_ms, data->scan_time);
+#endif
+
     data->scan_time += config->debounce_scan_period_ms;
 
     k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
@@ -166,7 +177,8 @@ static void kscan_direct_read_end(const struct device *dev) {
     struct kscan_direct_data *data = dev->data;
     const struct kscan_direct_config *config = dev->config;
 
-    data->scan_time += config->poll_period_ms;
+    data->scan_time +=
+        kscan_poll_next_period(&data->poll, config->poll_period_ms, data->scan_time);
 
     // Return to polling slowly.
     k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
@@ -195,6 +207,9 @@ static int kscan_direct_read(const struct device *dev) {
 
     // Process the new state.
     bool continue_scan = false;
+    struct zmk_kscan_batch batch;
+
+    zmk_kscan_batch_begin(&batch, dev, data->callback, data->batch_callback, data->scan_time);
 
     for (int i = 0; i < data->inputs.len; i++) {
         const struct kscan_gpio *gpio = &data->inputs.gpios[i];
@@ -204,7 +219,7 @@ static int kscan_direct_read(const struct device *dev) {
             const bool pressed = zmk_debounce_is_pressed(deb_state);
 
             LOG_DBG("Sending event at 0,%i state %s", gpio->index, pressed ? "on" : "off");
-            data->callback(dev, 0, gpio->index, pressed);
+            zmk_kscan_batch_report(&batch, 0, gpio->index, pressed);
             if (config->toggle_mode && pressed) {
                 kscan_inputs_set_flags(&data->inputs, &gpio->spec);
             }
@@ -213,6 +228,8 @@ static int kscan_direct_read(const struct device *dev) {
         continue_scan = continue_scan || zmk_debounce_is_active(deb_state);
     }
 
+    zmk_kscan_batch_end(&batch);
+
     if (continue_scan) {
         // At least one key is pressed or the debouncer has not yet decided if
         // it is pressed. Poll quickly until everything is released.
@@ -239,6 +256,19 @@ static int kscan_direct_configure(const struct device *dev, kscan_callback_t cal
     }
 
     data->callback = callback;
+    data->batch_callback = NULL;
+    return 0;
+}
+
+static int kscan_direct_configure_batch(const struct device *dev,
+                                        const zmk_kscan_batch_callback_t callback) {
+    struct kscan_direct_data *data = dev->data;
+
+    if (!callback) {
+        return -EINVAL;
+    }
+
+    data->batch_callback = callback;
     return 0;
 }
 
@@ -247,6 +277,12 @@ static int kscan_direct_enable(const struct device *dev) {
 
     data->scan_time = k_uptime_get();
 
+#if USE_POLLING
+    const struct kscan_direct_config *config = dev->config;
+
+    kscan_poll_reset(&data->poll, config->poll_period_ms, data->scan_time);
+#endif
+
     // Read will automatically start interrupts/polling once done.
     return kscan_direct_read(dev);
 }
@@ -412,6 +448,9 @@ static const struct kscan_driver_api kscan_direct_api = {
                                                                                                    \
     DEVICE_DT_INST_DEFINE(n, &kscan_direct_init, PM_DEVICE_DT_INST_GET(n), &kscan_direct_data_##n, \
                           &kscan_direct_config_##n, POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,       \
-                          &kscan_direct_api);
+                          &kscan_direct_api);                                                      \
+                                                                                                   \
+    ZMK_KSCAN_BATCH_DRIVER(kscan_direct_batch_##n, DEVICE_DT_INST_GET(n),                          \
+                           kscan_direct_configure_batch);
 
 DT_INST_FOREACH_STATUS_OKAY(KSCAN_DIRECT_INIT);
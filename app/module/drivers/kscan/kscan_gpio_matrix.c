@@ -5,6 +5,7 @@
  */
 
 #include "kscan_gpio.h"
+#include "kscan_poll.h"
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -17,6 +18,7 @@
 #include <zephyr/sys/util.h>
 
 #include <zmk/debounce.h>
+#include <zmk/kscan_batch.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -30,6 +32,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define INST_COLS_LEN(n) DT_INST_PROP_LEN(n, col_gpios)
 #define INST_MATRIX_LEN(n) (INST_ROWS_LEN(n) * INST_COLS_LEN(n))
 #define INST_INPUTS_LEN(n) COND_DIODE_DIR(n, (INST_COLS_LEN(n)), (INST_ROWS_LEN(n)))
+#define INST_OUTPUTS_LEN(n) COND_DIODE_DIR(n, (INST_ROWS_LEN(n)), (INST_COLS_LEN(n)))
 
 #if CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS >= 0
 #define INST_DEBOUNCE_PRESS_MS(n) CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS
@@ -67,14 +70,35 @@ struct kscan_matrix_irq_callback {
     struct gpio_callback callback;
 };
 
+/**
+ * A run of consecutive outputs in the port-sorted output list which share the same port.
+ */
+struct kscan_gpio_port_group {
+    const struct device *port;
+    /** Bit mask of all pins in this group. */
+    gpio_port_pins_t mask;
+    /** Index of the first pin of this group in the output list. */
+    size_t start;
+    /** Number of pins in this group. */
+    size_t len;
+};
+
 struct kscan_matrix_data {
     const struct device *dev;
     struct kscan_gpio_list inputs;
+    /** Outputs grouped by port. Array of length config->outputs.len */
+    struct kscan_gpio_port_group *output_ports;
+    /** Number of used items in output_ports. */
+    size_t output_ports_len;
     kscan_callback_t callback;
+    zmk_kscan_batch_callback_t batch_callback;
     struct k_work_delayable work;
 #if USE_INTERRUPTS
     /** Array of length config->inputs.len */
     struct kscan_matrix_irq_callback *irqs;
+#endif
+#if USE_POLLING
+    struct kscan_poll_state poll;
 #endif
     /** Timestamp of the current or scheduled scan. */
     int64_t scan_time;
@@ -116,14 +140,15 @@ static int state_index_io(const struct kscan_matrix_config *config, const int in
 }
 
 static int kscan_matrix_set_all_outputs(const struct device *dev, const int value) {
-    const struct kscan_matrix_config *config = dev->config;
+    const struct kscan_matrix_data *data = dev->data;
 
-    for (int i = 0; i < config->outputs.len; i++) {
-        const struct gpio_dt_spec *gpio = &config->outputs.gpios[i].spec;
+    // Write each output port once, which is a single bus transfer for GPIO expanders.
+    for (int i = 0; i < data->output_ports_len; i++) {
+        const struct kscan_gpio_port_group *group = &data->output_ports[i];
 
-        int err = gpio_pin_set_dt(gpio, value);
+        int err = gpio_port_set_masked(group->port, group->mask, value ? group->mask : 0);
         if (err) {
-            LOG_ERR("Failed to set output %i to %i: %i", i, value, err);
+            LOG_ERR("Failed to set outputs on %s to %i: %i", group->port->name, value, err);
             return err;
         }
     }
@@ -131,6 +156,39 @@ static int kscan_matrix_set_all_outputs(const struct device *dev, const int valu
     return 0;
 }
 
+/**
+ * Set an output active and the previously active output, if any, inactive. If both outputs are on
+ * the same port, this is done with a single port write, so an output driven by a GPIO expander
+ * such as a 595 shift register needs one bus transfer per output instead of two.
+ */
+static int kscan_matrix_select_output(const struct kscan_gpio *prev_gpio,
+                                      const struct kscan_gpio *out_gpio) {
+    if (prev_gpio && prev_gpio->spec.port == out_gpio->spec.port) {
+        const gpio_port_pins_t out_mask = BIT(out_gpio->spec.pin);
+
+        int err = gpio_port_set_masked(out_gpio->spec.port, BIT(prev_gpio->spec.pin) | out_mask,
+                                       out_mask);
+        if (err) {
+            LOG_ERR("Failed to set output %i active: %i", out_gpio->index, err);
+        }
+        return err;
+    }
+
+    if (prev_gpio) {
+        int err = gpio_pin_set_dt(&prev_gpio->spec, 0);
+        if (err) {
+            LOG_ERR("Failed to set output %i inactive: %i", prev_gpio->index, err);
+            return err;
+        }
+    }
+
+    int err = gpio_pin_set_dt(&out_gpio->spec, 1);
+    if (err) {
+        LOG_ERR("Failed to set output %i active: %i", out_gpio->index, err);
+    }
+    return err;
+}
+
 #if USE_INTERRUPTS
 static int kscan_matrix_interrupt_configure(const struct device *dev, const gpio_flags_t flags) {
     const struct kscan_matrix_data *data = dev->data;
@@ -195,6 +253,11 @@ static void kscan_matrix_read_continue(const struct device *dev) {
     const struct kscan_matrix_config *config = dev->config;
     struct kscan_matrix_data *data = dev->data;
 
+#if USE_POLLING
+    // A key is active, so go back to the fastest idle polling rate once it is released.
+    kscan_poll_reset(&data->poll, config->poll_period_ms, data->scan_time);
+#endif
+
     data->scan_time += config->debounce_scan_period_ms;
 
     k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
@@ -208,7 +271,8 @@ static void kscan_matrix_read_end(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
     const struct kscan_matrix_config *config = dev->config;
 
-    data->scan_time += config->poll_period_ms;
+    data->scan_time +=
+        kscan_poll_next_period(&data->poll, config->poll_period_ms, data->scan_time);
 
     // Return to polling slowly.
     k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
@@ -219,13 +283,15 @@ static int kscan_matrix_read(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
     const struct kscan_matrix_config *config = dev->config;
 
+    const struct kscan_gpio *prev_gpio = NULL;
+    int err;
+
     // Scan the matrix.
     for (int i = 0; i < config->outputs.len; i++) {
         const struct kscan_gpio *out_gpio = &config->outputs.gpios[i];
 
-        int err = gpio_pin_set_dt(&out_gpio->spec, 1);
+        err = kscan_matrix_select_output(prev_gpio, out_gpio);
         if (err) {
-            LOG_ERR("Failed to set output %i active: %i", out_gpio->index, err);
             return err;
         }
 
@@ -248,19 +314,33 @@ static int kscan_matrix_read(const struct device *dev) {
                                 &config->debounce_config);
         }
 
+#if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS > 0
         err = gpio_pin_set_dt(&out_gpio->spec, 0);
         if (err) {
             LOG_ERR("Failed to set output %i inactive: %i", out_gpio->index, err);
             return err;
         }
 
-#if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS > 0
         k_busy_wait(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS);
+#else
+        // The next output is selected and this one deselected together.
+        prev_gpio = out_gpio;
 #endif
     }
 
+    if (prev_gpio) {
+        err = gpio_pin_set_dt(&prev_gpio->spec, 0);
+        if (err) {
+            LOG_ERR("Failed to set output %i inactive: %i", prev_gpio->index, err);
+            return err;
+        }
+    }
+
     // Process the new state.
     bool continue_scan = false;
+    struct zmk_kscan_batch batch;
+
+    zmk_kscan_batch_begin(&batch, dev, data->callback, data->batch_callback, data->scan_time);
 
     for (int r = 0; r < config->rows; r++) {
         for (int c = 0; c < config->cols; c++) {
@@ -271,13 +351,15 @@ static int kscan_matrix_read(const struct device *dev) {
                 const bool pressed = zmk_debounce_is_pressed(state);
 
                 LOG_DBG("Sending event at %i,%i state %s", r, c, pressed ? "on" : "off");
-                data->callback(dev, r, c, pressed);
+                zmk_kscan_batch_report(&batch, r, c, pressed);
             }
 
             continue_scan = continue_scan || zmk_debounce_is_active(state);
         }
     }
 
+    zmk_kscan_batch_end(&batch);
+
     if (continue_scan) {
         // At least one key is pressed or the debouncer has not yet decided if
         // it is pressed. Poll quickly until everything is released.
@@ -304,6 +386,19 @@ static int kscan_matrix_configure(const struct device *dev, const kscan_callback
     }
 
     data->callback = callback;
+    data->batch_callback = NULL;
+    return 0;
+}
+
+static int kscan_matrix_configure_batch(const struct device *dev,
+                                        const zmk_kscan_batch_callback_t callback) {
+    struct kscan_matrix_data *data = dev->data;
+
+    if (!callback) {
+        return -EINVAL;
+    }
+
+    data->batch_callback = callback;
     return 0;
 }
 
@@ -312,6 +407,12 @@ static int kscan_matrix_enable(const struct device *dev) {
 
     data->scan_time = k_uptime_get();
 
+#if USE_POLLING
+    const struct kscan_matrix_config *config = dev->config;
+
+    kscan_poll_reset(&data->poll, config->poll_period_ms, data->scan_time);
+#endif
+
     // Read will automatically start interrupts/polling once done.
     return kscan_matrix_read(dev);
 }
@@ -443,14 +544,48 @@ static void kscan_matrix_setup_pins(const struct device *dev) {
     kscan_matrix_set_all_outputs(dev, 0);
 }
 
+/**
+ * Splits a GPIO list sorted by kscan_gpio_list_sort_by_port() into groups of pins which share a
+ * port. @p groups must have space for list->len items. Returns the number of groups.
+ */
+static size_t kscan_matrix_group_by_port(const struct kscan_gpio_list *list,
+                                         struct kscan_gpio_port_group *groups) {
+    size_t count = 0;
+
+    for (size_t i = 0; i < list->len; i++) {
+        const struct kscan_gpio *gpio = &list->gpios[i];
+
+        if (count == 0 || groups[count - 1].port != gpio->spec.port) {
+            groups[count++] = (struct kscan_gpio_port_group){
+                .port = gpio->spec.port,
+                .mask = 0,
+                .start = i,
+                .len = 0,
+            };
+        }
+
+        struct kscan_gpio_port_group *group = &groups[count - 1];
+        group->mask |= BIT(gpio->spec.pin);
+        group->len++;
+    }
+
+    return count;
+}
+
 static int kscan_matrix_init(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
 
     data->dev = dev;
 
     // Sort inputs by port so we can read each port just once per scan.
     kscan_gpio_list_sort_by_port(&data->inputs);
 
+    // Likewise for outputs, so consecutive outputs can be switched with a single port write.
+    struct kscan_gpio_list outputs = config->outputs;
+    kscan_gpio_list_sort_by_port(&outputs);
+    data->output_ports_len = kscan_matrix_group_by_port(&outputs, data->output_ports);
+
     k_work_init_delayable(&data->work, kscan_matrix_work_handler);
 
 #if IS_ENABLED(CONFIG_PM_DEVICE)
@@ -506,12 +641,15 @@ static const struct kscan_driver_api kscan_matrix_api = {
                                                                                                    \
     static struct zmk_debounce_state kscan_matrix_state_##n[INST_MATRIX_LEN(n)];                   \
                                                                                                    \
+    static struct kscan_gpio_port_group kscan_matrix_output_ports_##n[INST_OUTPUTS_LEN(n)];        \
+                                                                                                   \
     COND_INTERRUPTS(                                                                               \
         (static struct kscan_matrix_irq_callback kscan_matrix_irqs_##n[INST_INPUTS_LEN(n)];))      \
                                                                                                    \
     static struct kscan_matrix_data kscan_matrix_data_##n = {                                      \
         .inputs =                                                                                  \
             KSCAN_GPIO_LIST(COND_DIODE_DIR(n, (kscan_matrix_cols_##n), (kscan_matrix_rows_##n))),  \
+        .output_ports = kscan_matrix_output_ports_##n,                                             \
         .matrix_state = kscan_matrix_state_##n,                                                    \
         COND_INTERRUPTS((.irqs = kscan_matrix_irqs_##n, ))};                                       \
                                                                                                    \
@@ -534,6 +672,9 @@ static const struct kscan_driver_api kscan_matrix_api = {
                                                                                                    \
     DEVICE_DT_INST_DEFINE(n, &kscan_matrix_init, PM_DEVICE_DT_INST_GET(n), &kscan_matrix_data_##n, \
                           &kscan_matrix_config_##n, POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,       \
-                          &kscan_matrix_api);
+                          &kscan_matrix_api);                                                      \
+                                                                                                   \
+    ZMK_KSCAN_BATCH_DRIVER(kscan_matrix_batch_##n, DEVICE_DT_INST_GET(n),                          \
+                           kscan_matrix_configure_batch);
 
 DT_INST_FOREACH_STATUS_OKAY(KSCAN_MATRIX_INIT);
@@ -15,9 +15,11 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <dt-bindings/zmk/kscan_mock.h>
+#include <zmk/kscan_batch.h>
 
 struct kscan_mock_data {
     kscan_callback_t callback;
+    zmk_kscan_batch_callback_t batch_callback;
 
     uint32_t event_index;
     struct k_work_delayable work;
@@ -40,6 +42,21 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
 
     data->event_index = 0;
     data->callback = callback;
+    data->batch_callback = NULL;
+
+    return 0;
+}
+
+static int kscan_mock_configure_batch(const struct device *dev,
+                                      zmk_kscan_batch_callback_t callback) {
+    struct kscan_mock_data *data = dev->data;
+
+    if (!callback) {
+        return -EINVAL;
+    }
+
+    data->event_index = 0;
+    data->batch_callback = callback;
 
     return 0;
 }
@@ -48,6 +65,7 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
     struct kscan_mock_config_##n {                                                                 \
         uint32_t events[DT_INST_PROP_LEN(n, events)];                                              \
         bool exit_after;                                                                           \
+        bool batch_simultaneous_events;                                                            \
     };                                                                                             \
     static void kscan_mock_schedule_next_event_##n(const struct device *dev) {                     \
         struct kscan_mock_data *data = dev->data;                                                  \
@@ -71,10 +89,23 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
             else                                                                                   \
                 return;                                                                            \
         }                                                                                          \
-        uint32_t ev = cfg->events[data->event_index];                                              \
-        LOG_DBG("ev %u row %d column %d state %d\n", ev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev),       \
-                ZMK_MOCK_IS_PRESS(ev));                                                            \
-        data->callback(data->dev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev), ZMK_MOCK_IS_PRESS(ev));      \
+        struct zmk_kscan_batch batch;                                                              \
+        zmk_kscan_batch_begin(&batch, data->dev, data->callback, data->batch_callback,             \
+                              k_uptime_get());                                                     \
+        /* Events with no delay between them can be reported together in one batch. */             \
+        for (;;) {                                                                                 \
+            uint32_t ev = cfg->events[data->event_index];                                          \
+            LOG_DBG("ev %u row %d column %d state %d\n", ev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev),   \
+                    ZMK_MOCK_IS_PRESS(ev));                                                        \
+            zmk_kscan_batch_report(&batch, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev),                     \
+                                   ZMK_MOCK_IS_PRESS(ev));                                         \
+            if (!data->batch_callback || !cfg->batch_simultaneous_events ||                        \
+                ZMK_MOCK_MSEC(ev) > 0 || data->event_index + 1 >= DT_INST_PROP_LEN(n, events)) {   \
+                break;                                                                             \
+            }                                                                                      \
+            data->event_index++;                                                                   \
+        }                                                                                          \
+        zmk_kscan_batch_end(&batch);                                                               \
         kscan_mock_schedule_next_event_##n(data->dev);                                             \
         data->event_index++;                                                                       \
     }                                                                                              \
@@ -95,9 +126,12 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
     };                                                                                             \
     static struct kscan_mock_data kscan_mock_data_##n;                                             \
     static const struct kscan_mock_config_##n kscan_mock_config_##n = {                            \
-        .events = DT_INST_PROP(n, events), .exit_after = DT_INST_PROP(n, exit_after)};             \
+        .events = DT_INST_PROP(n, events),                                                         \
+        .exit_after = DT_INST_PROP(n, exit_after),                                                 \
+        .batch_simultaneous_events = DT_INST_PROP(n, batch_simultaneous_events)};                  \
     DEVICE_DT_INST_DEFINE(n, kscan_mock_init_##n, NULL, &kscan_mock_data_##n,                      \
                           &kscan_mock_config_##n, POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,         \
-                          &mock_driver_api_##n);
+                          &mock_driver_api_##n);                                                   \
+    ZMK_KSCAN_BATCH_DRIVER(kscan_mock_batch_##n, DEVICE_DT_INST_GET(n), kscan_mock_configure_batch);
 
 DT_INST_FOREACH_STATUS_OKAY(MOCK_INST_INIT)
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "kscan_poll.h"
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+static void kscan_poll_set_period(struct kscan_poll_state *state, int32_t period_ms, int64_t now) {
+    if (state->period_ms == period_ms) {
+        return;
+    }
+
+    const int64_t elapsed = now - state->period_start;
+    if (state->period_ms > 0 && elapsed > 0) {
+        LOG_DBG("Scan period %d -> %d ms. %u idle scans in %lld ms (%lld Hz)", state->period_ms,
+                period_ms, state->scans, elapsed, (state->scans * 1000LL) / elapsed);
+    }
+
+    state->period_ms = period_ms;
+    state->period_start = now;
+    state->scans = 0;
+}
+
+void kscan_poll_reset(struct kscan_poll_state *state, int32_t base_period_ms, int64_t now) {
+    kscan_poll_set_period(state, base_period_ms, now);
+
+    // Debounce scans are not idle, so the idle time and scan count start over from here
+    state->period_start = now;
+    state->scans = 0;
+}
+
+int32_t kscan_poll_next_period(struct kscan_poll_state *state, int32_t base_period_ms,
+                               int64_t now) {
+    state->scans++;
+
+    if (!IS_ENABLED(CONFIG_ZMK_KSCAN_ADAPTIVE_POLLING) || state->period_ms < base_period_ms) {
+        kscan_poll_set_period(state, base_period_ms, now);
+        return state->period_ms;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_ADAPTIVE_POLLING)
+    if (state->period_ms < CONFIG_ZMK_KSCAN_ADAPTIVE_POLLING_MAX_PERIOD_MS &&
+        now - state->period_start >= CONFIG_ZMK_KSCAN_ADAPTIVE_POLLING_IDLE_MS) {
+        kscan_poll_set_period(
+            state, MIN(state->period_ms * 2, CONFIG_ZMK_KSCAN_ADAPTIVE_POLLING_MAX_PERIOD_MS), now);
+    }
+#endif
+
+    return state->period_ms;
+}
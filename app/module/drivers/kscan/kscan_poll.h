@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Tracks the idle polling period of a kscan driver which polls for key presses.
+ *
+ * With CONFIG_ZMK_KSCAN_ADAPTIVE_POLLING enabled, the period starts at the driver's configured
+ * poll period and doubles each time the keys have been idle for
+ * CONFIG_ZMK_KSCAN_ADAPTIVE_POLLING_IDLE_MS, up to CONFIG_ZMK_KSCAN_ADAPTIVE_POLLING_MAX_PERIOD_MS.
+ * Otherwise, the period is always the configured poll period.
+ *
+ * Must be zero-initialized before the first use.
+ */
+struct kscan_poll_state {
+    /** Current time between idle reads in milliseconds. */
+    int32_t period_ms;
+    /** Timestamp of the last change to period_ms or the last active key. */
+    int64_t period_start;
+    /** Number of idle reads since period_start. */
+    uint32_t scans;
+};
+
+/**
+ * Returns to the fastest idle polling period. Call this whenever a key is active or debouncing.
+ *
+ * @param state The polling state.
+ * @param base_period_ms The poll period configured for the driver.
+ * @param now The timestamp of the current read.
+ */
+void kscan_poll_reset(struct kscan_poll_state *state, int32_t base_period_ms, int64_t now);
+
+/**
+ * Get the time to wait before the next read while all keys are idle, backing off to a slower
+ * period if the keys have been idle long enough. Call this after every read which found all keys
+ * idle, as it also counts the read for the scan rate statistics.
+ *
+ * @param state The polling state.
+ * @param base_period_ms The poll period configured for the driver.
+ * @param now The timestamp of the current read.
+ *
+ * @returns The time in milliseconds until the next read.
+ */
+int32_t kscan_poll_next_period(struct kscan_poll_state *state, int32_t base_period_ms,
+                               int64_t now);
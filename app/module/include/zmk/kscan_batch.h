@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/kscan.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * @brief Batched keyboard scan events.
+ *
+ * Kscan drivers which register with ZMK_KSCAN_BATCH_DRIVER() can report all changes detected in
+ * one scan pass with a single callback instead of calling the kscan_callback_t once per change.
+ */
+
+struct zmk_kscan_batch_event {
+    uint32_t row;
+    uint32_t column;
+    bool pressed;
+};
+
+/**
+ * Callback for a batch of key changes.
+ *
+ * @param dev The kscan device which detected the changes.
+ * @param events The changes, in the order they were detected.
+ * @param len Number of items in @p events.
+ * @param timestamp Uptime in milliseconds of the scan which detected the changes.
+ */
+typedef void (*zmk_kscan_batch_callback_t)(const struct device *dev,
+                                           const struct zmk_kscan_batch_event *events, size_t len,
+                                           int64_t timestamp);
+
+typedef int (*zmk_kscan_batch_config_t)(const struct device *dev,
+                                        zmk_kscan_batch_callback_t callback);
+
+struct zmk_kscan_batch_driver {
+    const struct device *dev;
+    /**
+     * Configure the device to report changes with a batch callback. Calling kscan_config() on the
+     * device afterwards switches it back to reporting changes one at a time.
+     */
+    zmk_kscan_batch_config_t config;
+};
+
+/**
+ * Register a kscan device as supporting batched callbacks.
+ *
+ * @param name A unique identifier for the registration.
+ * @param _dev The kscan device.
+ * @param _config The zmk_kscan_batch_config_t function for the device.
+ */
+#define ZMK_KSCAN_BATCH_DRIVER(name, _dev, _config)                                                \
+    static const STRUCT_SECTION_ITERABLE(zmk_kscan_batch_driver, name) = {                         \
+        .dev = _dev,                                                                               \
+        .config = _config,                                                                         \
+    }
+
+/**
+ * Configure a kscan device to report changes with a batch callback.
+ *
+ * @retval 0 on success.
+ * @retval -ENOTSUP if the device does not support batched callbacks. Use kscan_config() instead.
+ */
+static inline int zmk_kscan_batch_config(const struct device *dev,
+                                         zmk_kscan_batch_callback_t callback) {
+    STRUCT_SECTION_FOREACH(zmk_kscan_batch_driver, drv) {
+        if (drv->dev == dev) {
+            return drv->config(dev, callback);
+        }
+    }
+
+    return -ENOTSUP;
+}
+
+/**
+ * Collects the changes detected in one scan pass so a driver can report them together.
+ *
+ * If no batch callback is set, each change is reported immediately with the per-key callback.
+ */
+struct zmk_kscan_batch {
+    const struct device *dev;
+    kscan_callback_t callback;
+    zmk_kscan_batch_callback_t batch_callback;
+    int64_t timestamp;
+    size_t len;
+    struct zmk_kscan_batch_event events[CONFIG_ZMK_KSCAN_BATCH_SIZE];
+};
+
+static inline void zmk_kscan_batch_begin(struct zmk_kscan_batch *batch, const struct device *dev,
+                                         kscan_callback_t callback,
+                                         zmk_kscan_batch_callback_t batch_callback,
+                                         int64_t timestamp) {
+    batch->dev = dev;
+    batch->callback = callback;
+    batch->batch_callback = batch_callback;
+    batch->timestamp = timestamp;
+    batch->len = 0;
+}
+
+/**
+ * Send any pending changes to the batch callback.
+ */
+static inline void zmk_kscan_batch_end(struct zmk_kscan_batch *batch) {
+    if (batch->len > 0) {
+        batch->batch_callback(batch->dev, batch->events, batch->len, batch->timestamp);
+        batch->len = 0;
+    }
+}
+
+/**
+ * Add a change to the batch. If the batch is full, the pending changes are sent first.
+ */
+static inline void zmk_kscan_batch_report(struct zmk_kscan_batch *batch, uint32_t row,
+                                          uint32_t column, bool pressed) {
+    if (!batch->batch_callback) {
+        batch->callback(batch->dev, row, column, pressed);
+        return;
+    }
+
+    if (batch->len >= ARRAY_SIZE(batch->events)) {
+        zmk_kscan_batch_end(batch);
+    }
+
+    batch->events[batch->len++] = (struct zmk_kscan_batch_event){
+        .row = row,
+        .column = column,
+        .pressed = pressed,
+    };
+}
@@ -0,0 +1,469 @@
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""Studio RPC load test for the native_posix build.
+
+Starts a native_posix build with the studio-rpc-pty snippet, talks to the UART
+RPC transport over its pseudo-terminal and reports request latency percentiles,
+throughput and the peak RX/TX buffer usage logged by the firmware.
+
+Only the standard library is used, so the few messages needed are encoded by
+hand. Field numbers mirror the zmk-studio-messages protos.
+"""
+
+import argparse
+import os
+import re
+import select
+import subprocess
+import sys
+import termios
+import threading
+import time
+import tty
+from collections import defaultdict
+from pathlib import Path
+
+APP_DIR = Path(__file__).resolve().parents[2]
+CONFIG_DIR = Path(__file__).resolve().parent
+
+FRAMING_SOF = 0xAB
+FRAMING_ESC = 0xAC
+FRAMING_EOF = 0xAD
+
+# zmk.studio.Request / Response / RequestResponse
+REQUEST_ID = 1
+REQUEST_KEYMAP = 5
+RESPONSE_REQUEST_RESPONSE = 1
+REQUEST_RESPONSE_ID = 1
+REQUEST_RESPONSE_META = 2
+REQUEST_RESPONSE_KEYMAP = 5
+
+# zmk.keymap.Request / Response
+KEYMAP_GET_KEYMAP = 1
+KEYMAP_SET_LAYER_BINDING = 2
+KEYMAP_SAVE_CHANGES = 4
+KEYMAP_GET_PHYSICAL_LAYOUTS = 6
+
+# zmk.keymap.Keymap / Layer / BehaviorBinding
+KEYMAP_LAYERS = 1
+LAYER_ID = 1
+LAYER_BINDINGS = 3
+BINDING_BEHAVIOR_ID = 1
+BINDING_PARAM1 = 2
+BINDING_PARAM2 = 3
+
+WIRE_VARINT = 0
+WIRE_I64 = 1
+WIRE_LEN = 2
+WIRE_I32 = 5
+
+# Logged by the native POSIX UART driver for the board's second UART
+PTY_PATTERN = re.compile(r"uart_1 connected to pseudotty: (\S+)")
+BUF_USAGE_PATTERN = re.compile(r"(RX|TX) buffer peak usage: (\d+) of (\d+) bytes")
+
+
+def encode_varint(value):
+    out = bytearray()
+    value &= (1 << 64) - 1
+    while True:
+        b = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def field_varint(field, value):
+    return encode_varint(field << 3 | WIRE_VARINT) + encode_varint(value)
+
+
+def field_message(field, payload):
+    return encode_varint(field << 3 | WIRE_LEN) + encode_varint(len(payload)) + payload
+
+
+def decode_varint(buf, pos):
+    value = 0
+    shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return value, pos
+        shift += 7
+
+
+def decode_fields(buf):
+    """Split a message into (field, value) pairs. Length delimited values are bytes."""
+    fields = []
+    pos = 0
+    while pos < len(buf):
+        key, pos = decode_varint(buf, pos)
+        field, wire = key >> 3, key & 0x7
+        if wire == WIRE_VARINT:
+            value, pos = decode_varint(buf, pos)
+        elif wire == WIRE_LEN:
+            length, pos = decode_varint(buf, pos)
+            value = buf[pos : pos + length]
+            pos += length
+        elif wire == WIRE_I64:
+            value = buf[pos : pos + 8]
+            pos += 8
+        elif wire == WIRE_I32:
+            value = buf[pos : pos + 4]
+            pos += 4
+        else:
+            raise ValueError(f"Unsupported wire type {wire}")
+        fields.append((field, value))
+    return fields
+
+
+def first_field(fields, field):
+    return next((v for f, v in fields if f == field), None)
+
+
+def frame(payload):
+    out = bytearray([FRAMING_SOF])
+    for b in payload:
+        if b in (FRAMING_SOF, FRAMING_ESC, FRAMING_EOF):
+            out.append(FRAMING_ESC)
+        out.append(b)
+    out.append(FRAMING_EOF)
+    return bytes(out)
+
+
+def keymap_request(request_id, keymap_request_fields):
+    return field_varint(REQUEST_ID, request_id) + field_message(
+        REQUEST_KEYMAP, keymap_request_fields
+    )
+
+
+class Deframer:
+    def __init__(self):
+        self.frame = None
+        self.escaped = False
+
+    def feed(self, data):
+        frames = []
+        for b in data:
+            if self.escaped:
+                self.escaped = False
+                if self.frame is not None:
+                    self.frame.append(b)
+            elif b == FRAMING_SOF:
+                self.frame = bytearray()
+            elif b == FRAMING_ESC:
+                self.escaped = True
+            elif b == FRAMING_EOF:
+                if self.frame is not None:
+                    frames.append(bytes(self.frame))
+                self.frame = None
+            elif self.frame is not None:
+                self.frame.append(b)
+        return frames
+
+
+class StudioClient:
+    def __init__(self, pty_path, timeout):
+        self.fd = os.open(pty_path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd)
+        termios.tcflush(self.fd, termios.TCIOFLUSH)
+        self.timeout = timeout
+        self.deframer = Deframer()
+        self.pending = []
+        self.next_id = 1
+        self.bytes_sent = 0
+        self.bytes_received = 0
+
+    def close(self):
+        os.close(self.fd)
+
+    def call(self, build_request):
+        """Send one request and wait for its response, skipping any notifications."""
+        request_id = self.next_id
+        self.next_id += 1
+
+        data = frame(build_request(request_id))
+        start = time.perf_counter()
+        os.write(self.fd, data)
+        self.bytes_sent += len(data)
+
+        deadline = start + self.timeout
+        while True:
+            while self.pending:
+                response = decode_fields(self.pending.pop(0))
+                rr = first_field(response, RESPONSE_REQUEST_RESPONSE)
+                if rr is None:
+                    continue
+
+                rr_fields = decode_fields(rr)
+                if first_field(rr_fields, REQUEST_RESPONSE_ID) == request_id:
+                    return time.perf_counter() - start, rr_fields
+
+            remaining = deadline - time.perf_counter()
+            if remaining <= 0:
+                raise TimeoutError(f"No response to request {request_id}")
+
+            readable, _, _ = select.select([self.fd], [], [], remaining)
+            if readable:
+                chunk = os.read(self.fd, 4096)
+                self.bytes_received += len(chunk)
+                self.pending.extend(self.deframer.feed(chunk))
+
+
+class FirmwareLog(threading.Thread):
+    """Reads the firmware output for the pseudo-terminal and buffer usage peaks."""
+
+    def __init__(self, process):
+        super().__init__(daemon=True)
+        self.process = process
+        self.pty_path = None
+        self.pty_ready = threading.Event()
+        self.buf_usage = {}
+
+    def run(self):
+        for line in self.process.stdout:
+            match = PTY_PATTERN.search(line)
+            if match:
+                self.pty_path = match.group(1)
+                self.pty_ready.set()
+                continue
+
+            match = BUF_USAGE_PATTERN.search(line)
+            if match:
+                used, capacity = int(match.group(2)), int(match.group(3))
+                self.buf_usage[match.group(1)] = (used, capacity)
+
+        self.pty_ready.set()
+
+
+def get_keymap(client, stats):
+    elapsed, rr = client.call(
+        lambda rid: keymap_request(rid, field_varint(KEYMAP_GET_KEYMAP, 1))
+    )
+    stats["get_keymap"].append(elapsed)
+
+    keymap_resp = first_field(rr, REQUEST_RESPONSE_KEYMAP)
+    if keymap_resp is None:
+        raise RuntimeError("get_keymap failed, is the device locked?")
+
+    keymap = decode_fields(first_field(decode_fields(keymap_resp), KEYMAP_GET_KEYMAP))
+    layer = decode_fields(first_field(keymap, KEYMAP_LAYERS))
+    bindings = [decode_fields(v) for f, v in layer if f == LAYER_BINDINGS]
+
+    return first_field(layer, LAYER_ID) or 0, bindings
+
+
+def set_layer_binding_request(layer_id, position, binding):
+    behavior_id = first_field(binding, BINDING_BEHAVIOR_ID) or 0
+    param1 = first_field(binding, BINDING_PARAM1) or 0
+    param2 = first_field(binding, BINDING_PARAM2) or 0
+
+    # behavior_id is a zigzag encoded sint32 on the wire, so it is already encoded here
+    encoded = (
+        field_varint(BINDING_BEHAVIOR_ID, behavior_id)
+        + field_varint(BINDING_PARAM1, param1)
+        + field_varint(BINDING_PARAM2, param2)
+    )
+    request = (
+        field_varint(1, layer_id)
+        + field_varint(2, position)
+        + field_message(3, encoded)
+    )
+    return field_message(KEYMAP_SET_LAYER_BINDING, request)
+
+
+def binding_key(binding):
+    return tuple(
+        first_field(binding, f) or 0
+        for f in (BINDING_BEHAVIOR_ID, BINDING_PARAM1, BINDING_PARAM2)
+    )
+
+
+def pick_alternates(bindings):
+    # Two bindings of the same behavior with different parameters, e.g. &kp A and &kp B
+    first = bindings[0]
+    for binding in bindings[1:]:
+        if (
+            binding_key(binding)[0] == binding_key(first)[0]
+            and binding_key(binding) != binding_key(first)
+        ):
+            return first, binding
+
+    raise RuntimeError(
+        "The first layer needs two bindings of the same behavior with different "
+        "parameters"
+    )
+
+
+def run_mix(client, args, stats, errors):
+    layer_id, bindings = get_keymap(client, stats)
+    if not bindings:
+        raise RuntimeError("The keymap has no bindings to write back")
+
+    alternates = pick_alternates(bindings)
+    current = [binding_key(b) for b in bindings]
+
+    for _ in range(args.iterations):
+        get_keymap(client, stats)
+
+        # Each write swaps the position to whichever alternate it doesn't hold, so
+        # no write is a no-op and every save has changes to persist
+        for i in range(args.burst):
+            position = i % len(bindings)
+            holds_first = current[position] == binding_key(alternates[0])
+            binding = alternates[1 if holds_first else 0]
+            request = set_layer_binding_request(layer_id, position, binding)
+            elapsed, rr = client.call(lambda rid: keymap_request(rid, request))
+            stats["set_layer_binding"].append(elapsed)
+            if first_field(rr, REQUEST_RESPONSE_META) is not None:
+                errors["set_layer_binding"] += 1
+            else:
+                current[position] = binding_key(binding)
+
+        elapsed, rr = client.call(
+            lambda rid: keymap_request(rid, field_varint(KEYMAP_SAVE_CHANGES, 1))
+        )
+        stats["save_changes"].append(elapsed)
+        if first_field(rr, REQUEST_RESPONSE_META) is not None:
+            errors["save_changes"] += 1
+
+        elapsed, rr = client.call(
+            lambda rid: keymap_request(
+                rid, field_varint(KEYMAP_GET_PHYSICAL_LAYOUTS, 1)
+            )
+        )
+        stats["get_physical_layouts"].append(elapsed)
+        if first_field(rr, REQUEST_RESPONSE_META) is not None:
+            errors["get_physical_layouts"] += 1
+
+
+def percentile(samples, pct):
+    ordered = sorted(samples)
+    rank = max(0, -(-len(ordered) * pct // 100) - 1)
+    return ordered[rank]
+
+
+def report(stats, errors, client, elapsed, buf_usage):
+    print(
+        f"{'Request':<22} {'Count':>6} {'Errors':>6} {'p50 ms':>8} {'p90 ms':>8} "
+        f"{'p99 ms':>8} {'max ms':>8}"
+    )
+    for name, samples in stats.items():
+        print(
+            f"{name:<22} {len(samples):>6} {errors[name]:>6} "
+            + " ".join(
+                f"{percentile(samples, p) * 1000:>8.2f}" for p in (50, 90, 99, 100)
+            )
+        )
+
+    total = client.bytes_sent + client.bytes_received
+    print()
+    print(
+        f"Sent {client.bytes_sent} bytes, received {client.bytes_received} bytes "
+        f"in {elapsed:.2f} s ({total / elapsed:.0f} bytes/s)"
+    )
+
+    for name in ("RX", "TX"):
+        if name in buf_usage:
+            used, capacity = buf_usage[name]
+            print(f"Peak {name} buffer usage: {used} of {capacity} bytes")
+        else:
+            print(
+                f"Peak {name} buffer usage: not logged, "
+                "is CONFIG_ZMK_STUDIO_RPC_LOG_BUF_USAGE enabled?"
+            )
+
+
+def build(build_dir):
+    subprocess.run(
+        [
+            "west",
+            "build",
+            "-s",
+            str(APP_DIR),
+            "-d",
+            str(build_dir),
+            "-b",
+            "native_posix_64",
+            "-S",
+            "studio-rpc-pty",
+            "-p",
+            "--",
+            f"-DZMK_CONFIG={CONFIG_DIR}",
+        ],
+        check=True,
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--build-dir",
+        type=Path,
+        default=APP_DIR / "build" / "studio-load-test",
+        help="build directory of the native_posix_64 firmware",
+    )
+    parser.add_argument(
+        "--no-build", action="store_true", help="reuse the existing build"
+    )
+    parser.add_argument(
+        "--iterations", type=int, default=20, help="number of times to run the mix"
+    )
+    parser.add_argument(
+        "--burst",
+        type=int,
+        default=10,
+        help="set_layer_binding requests per iteration",
+    )
+    parser.add_argument(
+        "--timeout", type=float, default=5, help="seconds to wait for each response"
+    )
+    args = parser.parse_args()
+
+    if not args.no_build:
+        build(args.build_dir)
+
+    process = subprocess.Popen(
+        [str(args.build_dir / "zephyr" / "zmk.exe")],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+        text=True,
+        errors="replace",
+    )
+    firmware = FirmwareLog(process)
+    firmware.start()
+
+    try:
+        if not firmware.pty_ready.wait(10) or not firmware.pty_path:
+            print(
+                "The firmware did not report its RPC pseudo-terminal",
+                file=sys.stderr,
+            )
+            return 1
+
+        client = StudioClient(firmware.pty_path, args.timeout)
+        stats = defaultdict(list)
+        errors = defaultdict(int)
+
+        start = time.perf_counter()
+        try:
+            run_mix(client, args, stats, errors)
+        finally:
+            elapsed = time.perf_counter() - start
+            client.close()
+
+        # Let the last buffer usage logs through before reporting
+        time.sleep(0.2)
+        report(stats, errors, client, elapsed, firmware.buf_usage)
+    finally:
+        process.terminate()
+        process.wait()
+
+    return 1 if any(errors.values()) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
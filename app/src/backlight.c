@@ -10,6 +10,8 @@
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
 
+#include <stdlib.h>
+
 #include <zephyr/logging/log.h>
 #include <zephyr/settings/settings.h>
 
@@ -57,23 +59,148 @@ static void zmk_backlight_central_send() {
 }
 #endif
 
-static int zmk_backlight_update(void) {
-#if ZMK_BLE_IS_CENTRAL
-    zmk_backlight_central_send();
-#endif
-    uint8_t brt = ((zmk_backlight_get_brt() * CONFIG_ZMK_BACKLIGHT_BRT_SCALE) / 100);
-    LOG_DBG("Update backlight brightness: %d%%", brt);
+// LED output level for each perceptual brightness level, following a gamma 2.2 curve. Fades move
+// at a constant rate along this curve, so they look even to the eye.
+static const uint8_t perceptual_to_output[BRT_MAX + 1] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 6, 6, 7, 7, 8,
+    8, 9, 9, 10, 11, 11, 12, 13, 13, 14, 15, 16, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28,
+    29, 30, 31, 33, 34, 35, 36, 37, 39, 40, 41, 43, 44, 46, 47, 49, 50, 52, 53, 55, 56, 58, 60, 61,
+    63, 65, 66, 68, 70, 72, 74, 75, 77, 79, 81, 83, 85, 87, 89, 91, 94, 96, 98, 100,
+};
+
+struct backlight_fade {
+    int64_t start_time;
+    // Perceptual levels, indexes into perceptual_to_output
+    uint8_t start;
+    uint8_t target;
+    uint8_t target_output;
+    // Level currently set on the LEDs, or -1 before the first update
+    int16_t output;
+};
+
+static struct backlight_fade fade = {.output = -1};
+
+// Fades are started from the system work queue and from the split peripheral's BT RX thread, and
+// stepped from the system work queue. LED drivers may sleep, so this is a mutex.
+static K_MUTEX_DEFINE(fade_mutex);
+
+static uint8_t backlight_output_to_perceptual(uint8_t output) {
+    uint8_t level = 0;
+    while (level < BRT_MAX && perceptual_to_output[level] < output) {
+        level++;
+    }
+
+    return level;
+}
+
+static int backlight_set_output(uint8_t output) {
+    if (fade.output == output) {
+        return 0;
+    }
 
     for (int i = 0; i < BACKLIGHT_NUM_LEDS; i++) {
-        int rc = led_set_brightness(backlight_dev, i, brt);
+        int rc = led_set_brightness(backlight_dev, i, output);
         if (rc != 0) {
             LOG_ERR("Failed to update backlight LED %d: %d", i, rc);
             return rc;
         }
     }
+
+    fade.output = output;
     return 0;
 }
 
+static void backlight_fade_timer_handler(struct k_timer *timer);
+
+K_TIMER_DEFINE(backlight_fade_timer, backlight_fade_timer_handler, NULL);
+
+// Sets the level for the current point of the fade, moving at least one output level along so the
+// first step of a fade is applied by the caller, and schedules the next step.
+static int backlight_fade_step(void) {
+    const int64_t elapsed = k_uptime_get() - fade.start_time;
+    const int span = fade.target - fade.start;
+
+    if (elapsed >= CONFIG_ZMK_BACKLIGHT_FADE_DURATION || span == 0) {
+        return backlight_set_output(fade.target_output);
+    }
+
+    const int direction = span > 0 ? 1 : -1;
+    int level = fade.start + span * elapsed / CONFIG_ZMK_BACKLIGHT_FADE_DURATION;
+    while (level != fade.target && perceptual_to_output[level] == fade.output) {
+        level += direction;
+    }
+
+    if (level == fade.target) {
+        return backlight_set_output(fade.target_output);
+    }
+
+    int rc = backlight_set_output(perceptual_to_output[level]);
+    if (rc != 0) {
+        return rc;
+    }
+
+    // Sleep until the output level actually changes, rather than waking for every step
+    int next = level;
+    while (next != fade.target && perceptual_to_output[next] == fade.output) {
+        next += direction;
+    }
+
+    int64_t next_time = CONFIG_ZMK_BACKLIGHT_FADE_DURATION;
+    if (next != fade.target) {
+        next_time = DIV_ROUND_UP(abs(next - fade.start) * CONFIG_ZMK_BACKLIGHT_FADE_DURATION,
+                                 abs(span));
+    }
+
+    k_timer_start(&backlight_fade_timer, K_MSEC(MAX(next_time - elapsed, 1)), K_NO_WAIT);
+    return 0;
+}
+
+static void backlight_fade_work_handler(struct k_work *work) {
+    k_mutex_lock(&fade_mutex, K_FOREVER);
+    backlight_fade_step();
+    k_mutex_unlock(&fade_mutex);
+}
+
+K_WORK_DEFINE(backlight_fade_work, backlight_fade_work_handler);
+
+static void backlight_fade_timer_handler(struct k_timer *timer) {
+    k_work_submit(&backlight_fade_work);
+}
+
+static int backlight_fade_to(uint8_t output) {
+    int rc;
+
+    k_mutex_lock(&fade_mutex, K_FOREVER);
+
+    if (CONFIG_ZMK_BACKLIGHT_FADE_DURATION == 0 || fade.output < 0) {
+        k_timer_stop(&backlight_fade_timer);
+        fade.target_output = output;
+        rc = backlight_set_output(output);
+    } else {
+        fade.start = backlight_output_to_perceptual(fade.output);
+        fade.target = backlight_output_to_perceptual(output);
+        fade.target_output = output;
+        fade.start_time = k_uptime_get();
+
+        // Errors from the LED driver reach the caller through the first step, later steps only log
+        k_timer_stop(&backlight_fade_timer);
+        rc = backlight_fade_step();
+    }
+
+    k_mutex_unlock(&fade_mutex);
+    return rc;
+}
+
+static int zmk_backlight_update(void) {
+#if ZMK_BLE_IS_CENTRAL
+    zmk_backlight_central_send();
+#endif
+    uint8_t brt = ((zmk_backlight_get_brt() * CONFIG_ZMK_BACKLIGHT_BRT_SCALE) / 100);
+    LOG_DBG("Update backlight brightness: %d%%", brt);
+
+    return backlight_fade_to(brt);
+}
+
 #if IS_ENABLED(CONFIG_SETTINGS)
 static int backlight_settings_load_cb(const char *name, size_t len, settings_read_cb read_cb,
                                       void *cb_arg) {
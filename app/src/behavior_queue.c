@@ -6,6 +6,7 @@
 
 #include <zmk/behavior_queue.h>
 #include <zmk/behavior.h>
+#include <zmk/timer_wheel.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
@@ -25,10 +26,10 @@ struct q_item {
 
 K_MSGQ_DEFINE(zmk_behavior_queue_msgq, sizeof(struct q_item), CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE, 4);
 
-static void behavior_queue_process_next(struct k_work *work);
-static K_WORK_DELAYABLE_DEFINE(queue_work, behavior_queue_process_next);
+static void behavior_queue_process_next(struct zmk_timer *timer);
+static ZMK_TIMER_DEFINE(queue_timer, behavior_queue_process_next);
 
-static void behavior_queue_process_next(struct k_work *work) {
+static void behavior_queue_process_next(struct zmk_timer *timer) {
     struct q_item item = {.wait = 0};
 
     while (k_msgq_get(&zmk_behavior_queue_msgq, &item, K_NO_WAIT) == 0) {
@@ -51,7 +52,7 @@ static void behavior_queue_process_next(struct k_work *work) {
         LOG_DBG("Processing next queued behavior in %dms", item.wait);
 
         if (item.wait > 0) {
-            k_work_schedule(&queue_work, K_MSEC(item.wait));
+            zmk_timer_schedule(&queue_timer, item.wait);
             break;
         }
     }
@@ -74,8 +75,8 @@ int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
         return ret;
     }
 
-    if (!k_work_delayable_is_pending(&queue_work)) {
-        behavior_queue_process_next(&queue_work.work);
+    if (!zmk_timer_is_pending(&queue_timer)) {
+        behavior_queue_process_next(&queue_timer);
     }
 
     return 0;
@@ -22,6 +22,7 @@
 #include <zmk/matrix.h>
 #include <zmk/keymap.h>
 #include <zmk/virtual_key_position.h>
+#include <zmk/timer_wheel.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -121,7 +122,7 @@ uint32_t combo_lookup[ZMK_KEYMAP_LEN][BYTES_FOR_COMBOS_MASK] = {};
 struct active_combo active_combos[CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS] = {};
 uint8_t active_combo_count = 0;
 
-struct k_work_delayable timeout_task;
+struct zmk_timer timeout_task;
 int64_t timeout_task_timeout_at;
 
 // this keeps track of the last non-combo, non-mod key tap
@@ -394,7 +395,7 @@ static bool release_combo_key(int32_t position, int64_t timestamp) {
 }
 
 static int cleanup() {
-    k_work_cancel_delayable(&timeout_task);
+    zmk_timer_cancel(&timeout_task);
     memset(candidates, 0, BYTES_FOR_COMBOS_MASK * sizeof(uint32_t));
     if (fully_pressed_combo != INT16_MAX) {
         activate_combo(fully_pressed_combo);
@@ -410,12 +411,11 @@ static void update_timeout_task() {
     }
     if (first_timeout == LLONG_MAX) {
         timeout_task_timeout_at = 0;
-        k_work_cancel_delayable(&timeout_task);
+        zmk_timer_cancel(&timeout_task);
         return;
     }
-    if (k_work_schedule(&timeout_task, K_MSEC(first_timeout - k_uptime_get())) >= 0) {
-        timeout_task_timeout_at = first_timeout;
-    }
+    zmk_timer_schedule_at(&timeout_task, first_timeout);
+    timeout_task_timeout_at = first_timeout;
 }
 
 static int position_state_down(const zmk_event_t *ev, struct zmk_position_state_changed *data) {
@@ -472,7 +472,7 @@ static int position_state_up(const zmk_event_t *ev, struct zmk_position_state_ch
     return ZMK_EV_EVENT_BUBBLE;
 }
 
-static void combo_timeout_handler(struct k_work *item) {
+static void combo_timeout_handler(struct zmk_timer *timer) {
     if (timeout_task_timeout_at == 0 || k_uptime_get() < timeout_task_timeout_at) {
         // timer was cancelled or rescheduled.
         return;
@@ -525,7 +525,7 @@ static int combo_init(void) {
         active_combos[i].combo_idx = UINT16_MAX;
     }
 
-    k_work_init_delayable(&timeout_task, combo_timeout_handler);
+    zmk_timer_init(&timeout_task, combo_timeout_handler);
     LOG_WRN("Have %d combos!", ARRAY_SIZE(combos));
     for (int i = 0; i < ARRAY_SIZE(combos); i++) {
         initialize_combo(i);
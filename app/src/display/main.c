@@ -37,7 +37,23 @@ static lv_obj_t *screen;
 
 __attribute__((weak)) lv_obj_t *zmk_display_status_screen() { return NULL; }
 
-void display_tick_cb(struct k_work *work) { lv_task_handler(); }
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_ON_DEMAND_RENDER)
+static void display_schedule_tick(void);
+#endif
+
+void display_tick_cb(struct k_work *work) {
+    lv_task_handler();
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_ON_DEMAND_RENDER)
+    // Flush invalidated areas now instead of waiting for LVGL's refresh timer to come due, then
+    // only keep ticking while something is animating.
+    lv_refr_now(NULL);
+
+    if (lv_anim_count_running() > 0) {
+        display_schedule_tick();
+    }
+#endif
+}
 
 K_WORK_DEFINE(display_tick_work, display_tick_cb);
 
@@ -61,12 +77,38 @@ void display_timer_cb() { k_work_submit_to_queue(zmk_display_work_q(), &display_
 
 K_TIMER_DEFINE(display_timer, display_timer_cb, NULL);
 
+static bool blanked = true;
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_ON_DEMAND_RENDER)
+static void display_schedule_tick(void) {
+    if (blanked) {
+        return;
+    }
+
+    k_timer_start(&display_timer, K_MSEC(CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS), K_NO_WAIT);
+}
+#endif
+
+void zmk_display_request_render(void) {
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_ON_DEMAND_RENDER)
+    if (blanked) {
+        return;
+    }
+
+    // Requests made before the pending render runs are coalesced into it
+    k_work_submit_to_queue(zmk_display_work_q(), &display_tick_work);
+#endif
+}
+
 void unblank_display_cb(struct k_work *work) {
 #if DT_HAS_CHOSEN(zmk_display_led)
     led_on(display_led, display_led_idx);
 #endif
     display_blanking_off(display);
-#if !IS_ENABLED(CONFIG_ARCH_POSIX)
+    blanked = false;
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_ON_DEMAND_RENDER)
+    zmk_display_request_render();
+#elif !IS_ENABLED(CONFIG_ARCH_POSIX)
     k_timer_start(&display_timer, K_MSEC(CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS),
                   K_MSEC(CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS));
 #endif // !IS_ENABLED(CONFIG_ARCH_POSIX)
@@ -75,6 +117,7 @@ void unblank_display_cb(struct k_work *work) {
 #if IS_ENABLED(CONFIG_ZMK_DISPLAY_BLANK_ON_IDLE)
 
 void blank_display_cb(struct k_work *work) {
+    blanked = true;
 #if !IS_ENABLED(CONFIG_ARCH_POSIX)
     k_timer_stop(&display_timer);
 #endif // !IS_ENABLED(CONFIG_ARCH_POSIX)
@@ -73,8 +73,23 @@ static struct battery_status_state battery_status_get_state(const zmk_event_t *e
     };
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_battery_status, struct battery_status_state,
-                            battery_status_update_cb, battery_status_get_state)
+static bool battery_status_state_eq(const struct battery_status_state *a,
+                                    const struct battery_status_state *b) {
+    if (a->level != b->level) {
+        return false;
+    }
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+    if (a->usb_present != b->usb_present) {
+        return false;
+    }
+#endif /* IS_ENABLED(CONFIG_USB_DEVICE_STACK) */
+
+    return true;
+}
+
+ZMK_DISPLAY_WIDGET_LISTENER_EQ(widget_battery_status, struct battery_status_state,
+                               battery_status_update_cb, battery_status_get_state,
+                               battery_status_state_eq)
 
 ZMK_SUBSCRIPTION(widget_battery_status, zmk_battery_state_changed);
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
@@ -19,11 +19,12 @@ static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
 struct layer_status_state {
     zmk_keymap_layer_index_t index;
-    const char *label;
+    // Copied, since layer names can be changed in place. Longer names don't fit the label anyway.
+    char label[10];
 };
 
 static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state) {
-    if (state.label == NULL || strlen(state.label) == 0) {
+    if (strlen(state.label) == 0) {
         char text[8] = {};
 
         snprintf(text, sizeof(text), LV_SYMBOL_KEYBOARD " %i", state.index);
@@ -45,12 +46,22 @@ static void layer_status_update_cb(struct layer_status_state state) {
 
 static struct layer_status_state layer_status_get_state(const zmk_event_t *eh) {
     zmk_keymap_layer_index_t index = zmk_keymap_highest_layer_active();
-    return (struct layer_status_state){
-        .index = index, .label = zmk_keymap_layer_name(zmk_keymap_layer_index_to_id(index))};
+    const char *name = zmk_keymap_layer_name(zmk_keymap_layer_index_to_id(index));
+    struct layer_status_state state = {.index = index};
+
+    snprintf(state.label, sizeof(state.label), "%s", name ? name : "");
+
+    return state;
+}
+
+static bool layer_status_state_eq(const struct layer_status_state *a,
+                                  const struct layer_status_state *b) {
+    return a->index == b->index && strcmp(a->label, b->label) == 0;
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, layer_status_update_cb,
-                            layer_status_get_state)
+ZMK_DISPLAY_WIDGET_LISTENER_EQ(widget_layer_status, struct layer_status_state,
+                               layer_status_update_cb, layer_status_get_state,
+                               layer_status_state_eq)
 
 ZMK_SUBSCRIPTION(widget_layer_status, zmk_layer_state_changed);
 
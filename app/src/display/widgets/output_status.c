@@ -65,8 +65,14 @@ static void output_status_update_cb(struct output_status_state state) {
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_status_symbol(widget->obj, state); }
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_output_status, struct output_status_state,
-                            output_status_update_cb, get_state)
+static bool state_eq(const struct output_status_state *a, const struct output_status_state *b) {
+    return zmk_endpoint_instance_eq(a->selected_endpoint, b->selected_endpoint) &&
+           a->active_profile_connected == b->active_profile_connected &&
+           a->active_profile_bonded == b->active_profile_bonded;
+}
+
+ZMK_DISPLAY_WIDGET_LISTENER_EQ(widget_output_status, struct output_status_state,
+                               output_status_update_cb, get_state, state_eq)
 ZMK_SUBSCRIPTION(widget_output_status, zmk_endpoint_changed);
 // We don't get an endpoint changed event when the active profile connects/disconnects
 // but there wasn't another endpoint to switch from/to, so update on BLE events too.
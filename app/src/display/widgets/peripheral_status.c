@@ -38,8 +38,13 @@ static void output_status_update_cb(struct peripheral_status_state state) {
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_status_symbol(widget->obj, state); }
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_peripheral_status, struct peripheral_status_state,
-                            output_status_update_cb, get_state)
+static bool state_eq(const struct peripheral_status_state *a,
+                     const struct peripheral_status_state *b) {
+    return a->connected == b->connected;
+}
+
+ZMK_DISPLAY_WIDGET_LISTENER_EQ(widget_peripheral_status, struct peripheral_status_state,
+                               output_status_update_cb, get_state, state_eq)
 ZMK_SUBSCRIPTION(widget_peripheral_status, zmk_split_peripheral_status_changed);
 
 int zmk_widget_peripheral_status_init(struct zmk_widget_peripheral_status *widget,
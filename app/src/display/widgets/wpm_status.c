@@ -39,8 +39,13 @@ void wpm_status_update_cb(struct wpm_status_state state) {
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_wpm_symbol(widget->obj, state); }
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_wpm_status, struct wpm_status_state, wpm_status_update_cb,
-                            wpm_status_get_state)
+static bool wpm_status_state_eq(const struct wpm_status_state *a,
+                                const struct wpm_status_state *b) {
+    return a->wpm == b->wpm;
+}
+
+ZMK_DISPLAY_WIDGET_LISTENER_EQ(widget_wpm_status, struct wpm_status_state, wpm_status_update_cb,
+                               wpm_status_get_state, wpm_status_state_eq)
 ZMK_SUBSCRIPTION(widget_wpm_status, zmk_wpm_state_changed);
 
 int zmk_widget_wpm_status_init(struct zmk_widget_wpm_status *widget, lv_obj_t *parent) {
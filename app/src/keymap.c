@@ -7,6 +7,7 @@
 #include <drivers/behavior.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -81,9 +82,14 @@ static uint8_t keymap_layer_orders[ZMK_KEYMAP_LAYERS_LEN];
                          (DT_INST_FOREACH_CHILD_STATUS_OKAY_SEP(0, TRANSFORMED_LAYER, (, ))))),    \
             (0))};
 
+#if !IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS) &&                                              \
+    !IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+
 KEYMAP_VAR(zmk_keymap, COND_CODE_1(IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE), (), (const)),
            IS_ENABLED(CONFIG_ZMK_STUDIO))
 
+#endif
+
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
 KEYMAP_VAR(zmk_stock_keymap, const, 0)
@@ -108,6 +114,381 @@ static struct zmk_behavior_binding
 
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS) || IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+
+// Whether the binding is the stock one of the position. Behaviors are compared by name, since a
+// binding loaded from settings needn't point at the same name string as the stock keymap. Bindings
+// whose behavior isn't resolved yet are never stock, they are compared again once resolved.
+static bool binding_is_stock(zmk_keymap_layer_id_t layer, uint32_t position,
+                             const struct zmk_behavior_binding *binding) {
+    const struct zmk_behavior_binding *stock = &zmk_stock_keymap[layer][position];
+
+    if (binding->param1 != stock->param1 || binding->param2 != stock->param2) {
+        return false;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+    if (!binding->behavior_dev && binding->local_id > 0) {
+        return false;
+    }
+#endif
+
+    if (!binding->behavior_dev || !stock->behavior_dev) {
+        return binding->behavior_dev == stock->behavior_dev;
+    }
+
+    return binding->behavior_dev == stock->behavior_dev ||
+           strcmp(binding->behavior_dev, stock->behavior_dev) == 0;
+}
+
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+
+// A binding stored as the index of its behavior in the local ID map plus 16 bit params. Positions
+// still set to their stock binding are read from the stock keymap instead.
+struct zmk_keymap_packed_binding {
+    uint16_t behavior;
+    uint16_t param1;
+    uint16_t param2;
+};
+
+#define PACKED_BEHAVIOR_STOCK 0
+#define PACKED_BEHAVIOR_MASK BIT_MASK(14)
+#define PACKED_BEHAVIOR_NONE PACKED_BEHAVIOR_MASK
+// The params don't fit in 16 bits, param1 holds their index in the wide params pool
+#define PACKED_WIDE BIT(15)
+// The behavior is only known by its local ID, held in place of the index. Wide ones hold it in
+// param2 instead.
+#define PACKED_UNRESOLVED BIT(14)
+
+struct packed_wide_params {
+    uint32_t param1;
+    uint32_t param2;
+};
+
+static struct zmk_keymap_packed_binding zmk_keymap[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN];
+
+static struct packed_wide_params packed_wide_params[CONFIG_ZMK_KEYMAP_PACKED_WIDE_PARAMS];
+static uint32_t packed_wide_params_used[DIV_ROUND_UP(CONFIG_ZMK_KEYMAP_PACKED_WIDE_PARAMS, 32)];
+
+static int packed_wide_params_alloc(void) {
+    for (int i = 0; i < CONFIG_ZMK_KEYMAP_PACKED_WIDE_PARAMS; i++) {
+        if (!(packed_wide_params_used[i / 32] & BIT(i % 32))) {
+            WRITE_BIT(packed_wide_params_used[i / 32], i % 32, 1);
+            return i;
+        }
+    }
+
+    return -ENOMEM;
+}
+
+static void packed_release(struct zmk_keymap_packed_binding *packed) {
+    if (packed->behavior & PACKED_WIDE) {
+        WRITE_BIT(packed_wide_params_used[packed->param1 / 32], packed->param1 % 32, 0);
+    }
+
+    packed->behavior = PACKED_BEHAVIOR_STOCK;
+}
+
+static int packed_behavior_index(const char *name) {
+    size_t count;
+    STRUCT_SECTION_COUNT(zmk_behavior_local_id_map, &count);
+
+    for (int i = 0; i < MIN(count, PACKED_BEHAVIOR_NONE - 1); i++) {
+        struct zmk_behavior_local_id_map *item;
+        STRUCT_SECTION_GET(zmk_behavior_local_id_map, i, &item);
+
+        if (item->device->name == name || strcmp(item->device->name, name) == 0) {
+            return i + 1;
+        }
+    }
+
+    return -ENODEV;
+}
+
+static void keymap_binding_get(zmk_keymap_layer_id_t layer, uint32_t position,
+                               struct zmk_behavior_binding *binding) {
+    const struct zmk_keymap_packed_binding *packed = &zmk_keymap[layer][position];
+
+    if (packed->behavior == PACKED_BEHAVIOR_STOCK) {
+        *binding = zmk_stock_keymap[layer][position];
+        return;
+    }
+
+    uint16_t behavior = packed->behavior & PACKED_BEHAVIOR_MASK;
+
+    memset(binding, 0, sizeof(*binding));
+
+    if (packed->behavior & PACKED_UNRESOLVED) {
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        binding->local_id = (packed->behavior & PACKED_WIDE) ? packed->param2 : behavior;
+#endif
+    } else if (behavior != PACKED_BEHAVIOR_NONE) {
+        struct zmk_behavior_local_id_map *item;
+        STRUCT_SECTION_GET(zmk_behavior_local_id_map, behavior - 1, &item);
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        binding->local_id = item->local_id;
+#endif
+        binding->behavior_dev = item->device->name;
+    }
+
+    if (packed->behavior & PACKED_WIDE) {
+        binding->param1 = packed_wide_params[packed->param1].param1;
+        binding->param2 = packed_wide_params[packed->param1].param2;
+    } else {
+        binding->param1 = packed->param1;
+        binding->param2 = packed->param2;
+    }
+}
+
+static int store_binding(zmk_keymap_layer_id_t layer, uint32_t position,
+                         const struct zmk_behavior_binding *binding) {
+    struct zmk_keymap_packed_binding *packed = &zmk_keymap[layer][position];
+
+    if (binding_is_stock(layer, position, binding)) {
+        packed_release(packed);
+        return 0;
+    }
+
+    uint16_t behavior = PACKED_BEHAVIOR_NONE;
+    uint16_t local_id = 0;
+    bool narrow = binding->param1 <= UINT16_MAX && binding->param2 <= UINT16_MAX;
+
+    if (binding->behavior_dev) {
+        int ret = packed_behavior_index(binding->behavior_dev);
+        if (ret < 0) {
+            LOG_WRN("Can't pack binding to unknown behavior %s", binding->behavior_dev);
+            return ret;
+        }
+
+        behavior = ret;
+    }
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+    else if (binding->local_id > 0) {
+        // Bindings loaded before the local ID table are resolved on commit, keep them out of the
+        // wide params pool whenever the ID fits in place of the index
+        behavior = PACKED_UNRESOLVED;
+        local_id = binding->local_id;
+
+        if (narrow && local_id <= PACKED_BEHAVIOR_MASK) {
+            behavior |= local_id;
+            local_id = 0;
+        } else {
+            narrow = false;
+        }
+    }
+#endif
+
+    if (narrow) {
+        packed_release(packed);
+        *packed = (struct zmk_keymap_packed_binding){
+            .behavior = behavior,
+            .param1 = binding->param1,
+            .param2 = binding->param2,
+        };
+        return 0;
+    }
+
+    // Reuse the slot of the binding being replaced, so this can't fail when the pool is full
+    int slot = (packed->behavior & PACKED_WIDE) ? packed->param1 : packed_wide_params_alloc();
+    if (slot < 0) {
+        LOG_ERR("No room to pack the params of layer %d at %d, raise "
+                "CONFIG_ZMK_KEYMAP_PACKED_WIDE_PARAMS",
+                layer, position);
+        return slot;
+    }
+
+    packed_wide_params[slot] = (struct packed_wide_params){
+        .param1 = binding->param1,
+        .param2 = binding->param2,
+    };
+    *packed = (struct zmk_keymap_packed_binding){
+        .behavior = behavior | PACKED_WIDE,
+        .param1 = slot,
+        .param2 = local_id,
+    };
+
+    return 0;
+}
+
+static void reset_bindings(void) {
+    memset(zmk_keymap, 0, sizeof(zmk_keymap));
+    memset(packed_wide_params_used, 0, sizeof(packed_wide_params_used));
+}
+
+#define KEYMAP_BINDINGS_SIZE                                                                       \
+    (sizeof(zmk_keymap) + sizeof(packed_wide_params) + sizeof(packed_wide_params_used))
+
+#elif IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+
+// A binding that differs from the stock keymap
+struct keymap_override {
+    uint16_t key;
+    struct zmk_behavior_binding binding;
+};
+
+#define OVERRIDE_KEY(_layer, _position) ((_layer) * ZMK_KEYMAP_LEN + (_position))
+
+BUILD_ASSERT(ZMK_KEYMAP_LAYERS_LEN * ZMK_KEYMAP_LEN <= UINT16_MAX,
+             "Keymap too large for the binding overlay");
+
+// Sorted by key, so by layer then position
+static struct keymap_override keymap_overrides[CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS_MAX];
+static size_t keymap_overrides_len;
+
+// Layers with overrides, the others are read from the stock keymap without a search
+static zmk_keymap_layers_state_t keymap_override_layers;
+
+// Returns the index of the override for the key, or where it would be inserted
+static size_t find_override(uint16_t key) {
+    size_t low = 0;
+    size_t high = keymap_overrides_len;
+
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+
+        if (keymap_overrides[mid].key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static void keymap_binding_get(zmk_keymap_layer_id_t layer, uint32_t position,
+                               struct zmk_behavior_binding *binding) {
+    if (keymap_override_layers & BIT(layer)) {
+        uint16_t key = OVERRIDE_KEY(layer, position);
+        size_t idx = find_override(key);
+
+        if (idx < keymap_overrides_len && keymap_overrides[idx].key == key) {
+            *binding = keymap_overrides[idx].binding;
+            return;
+        }
+    }
+
+    *binding = zmk_stock_keymap[layer][position];
+}
+
+static bool override_in_layer(size_t idx, zmk_keymap_layer_id_t layer) {
+    return idx < keymap_overrides_len && keymap_overrides[idx].key / ZMK_KEYMAP_LEN == layer;
+}
+
+static int store_binding(zmk_keymap_layer_id_t layer, uint32_t position,
+                         const struct zmk_behavior_binding *binding) {
+    uint16_t key = OVERRIDE_KEY(layer, position);
+    size_t idx = find_override(key);
+    bool found = idx < keymap_overrides_len && keymap_overrides[idx].key == key;
+
+    if (binding_is_stock(layer, position, binding)) {
+        if (!found) {
+            return 0;
+        }
+
+        memmove(&keymap_overrides[idx], &keymap_overrides[idx + 1],
+                (keymap_overrides_len - idx - 1) * sizeof(keymap_overrides[0]));
+        keymap_overrides_len--;
+
+        WRITE_BIT(keymap_override_layers, layer,
+                  (idx > 0 && override_in_layer(idx - 1, layer)) || override_in_layer(idx, layer));
+        return 0;
+    }
+
+    if (!found) {
+        if (keymap_overrides_len == ARRAY_SIZE(keymap_overrides)) {
+            LOG_ERR("No room to override layer %d at %d, raise "
+                    "CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS_MAX",
+                    layer, position);
+            return -ENOMEM;
+        }
+
+        memmove(&keymap_overrides[idx + 1], &keymap_overrides[idx],
+                (keymap_overrides_len - idx) * sizeof(keymap_overrides[0]));
+        keymap_overrides_len++;
+
+        keymap_overrides[idx].key = key;
+        WRITE_BIT(keymap_override_layers, layer, 1);
+    }
+
+    keymap_overrides[idx].binding = *binding;
+
+    return 0;
+}
+
+static void reset_bindings(void) {
+    keymap_overrides_len = 0;
+    keymap_override_layers = 0;
+}
+
+#define KEYMAP_BINDINGS_SIZE (sizeof(keymap_overrides) + sizeof(keymap_override_layers))
+
+#else
+
+static inline void keymap_binding_get(zmk_keymap_layer_id_t layer, uint32_t position,
+                                      struct zmk_behavior_binding *binding) {
+    *binding = zmk_keymap[layer][position];
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
+static int store_binding(zmk_keymap_layer_id_t layer, uint32_t position,
+                         const struct zmk_behavior_binding *binding) {
+    zmk_keymap[layer][position] = *binding;
+    return 0;
+}
+
+static void reset_bindings(void) {
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+            zmk_keymap[l][k] = zmk_stock_keymap[l][k];
+        }
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
+#define KEYMAP_BINDINGS_SIZE sizeof(zmk_keymap)
+
+#endif
+
+// Bindings can be changed from the studio RPC thread while they are looked up for key presses
+static struct k_spinlock keymap_bindings_lock;
+
+static void keymap_binding_copy(zmk_keymap_layer_id_t layer, uint32_t position,
+                                struct zmk_behavior_binding *binding) {
+    k_spinlock_key_t key = k_spin_lock(&keymap_bindings_lock);
+
+    keymap_binding_get(layer, position, binding);
+
+    k_spin_unlock(&keymap_bindings_lock, key);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
+static int keymap_store_binding(zmk_keymap_layer_id_t layer, uint32_t position,
+                                const struct zmk_behavior_binding *binding) {
+    k_spinlock_key_t key = k_spin_lock(&keymap_bindings_lock);
+
+    int ret = store_binding(layer, position, binding);
+
+    k_spin_unlock(&keymap_bindings_lock, key);
+    return ret;
+}
+
+static void reload_from_stock_keymap(void) {
+    k_spinlock_key_t key = k_spin_lock(&keymap_bindings_lock);
+
+    reset_bindings();
+
+    k_spin_unlock(&keymap_bindings_lock, key);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
 #define ASSERT_LAYER_VAL(_layer, _fail_ret)                                                        \
     if ((_layer) >= ZMK_KEYMAP_LAYERS_LEN) {                                                       \
         return (_fail_ret);                                                                        \
@@ -227,35 +608,58 @@ const char *zmk_keymap_layer_name(zmk_keymap_layer_id_t layer_id) {
     return zmk_keymap_layer_names[layer_id];
 }
 
-const struct zmk_behavior_binding *
-zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx) {
+static int map_binding_idx(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx) {
     if (binding_idx >= ZMK_KEYMAP_LEN) {
-        return NULL;
+        return -EINVAL;
     }
 
-    ASSERT_LAYER_VAL(layer_id, NULL)
+    ASSERT_LAYER_VAL(layer_id, -EINVAL)
 
     const uint32_t *pos_map;
     int ret = zmk_physical_layouts_get_selected_to_stock_position_map(&pos_map);
     if (ret < 0) {
         LOG_WRN("Failed to get the position map, can't find the right binding to return (%d)", ret);
-        return NULL;
+        return ret;
     }
 
     if (binding_idx >= ret) {
         LOG_WRN("Can't return binding for unmapped binding index %d", binding_idx);
-        return NULL;
+        return -EINVAL;
     }
 
     uint32_t mapped_idx = pos_map[binding_idx];
 
     if (mapped_idx >= ZMK_KEYMAP_LEN) {
         LOG_WRN("Binding index %d mapped to an invalid key position %d", binding_idx, mapped_idx);
+        return -EINVAL;
+    }
+
+    return mapped_idx;
+}
+
+#if !IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS) &&                                              \
+    !IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+const struct zmk_behavior_binding *
+zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx) {
+    int mapped_idx = map_binding_idx(layer_id, binding_idx);
+    if (mapped_idx < 0) {
         return NULL;
     }
 
     return &zmk_keymap[layer_id][mapped_idx];
 }
+#endif
+
+int zmk_keymap_get_layer_binding_copy(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx,
+                                      struct zmk_behavior_binding *binding) {
+    int mapped_idx = map_binding_idx(layer_id, binding_idx);
+    if (mapped_idx < 0) {
+        return mapped_idx;
+    }
+
+    keymap_binding_copy(layer_id, mapped_idx, binding);
+    return 0;
+}
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
@@ -290,19 +694,24 @@ int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t
         return -EINVAL;
     }
 
-    if (memcmp(&zmk_keymap[layer_id][storage_binding_idx], &binding, sizeof(binding)) == 0) {
+    struct zmk_behavior_binding current;
+    keymap_binding_copy(layer_id, storage_binding_idx, &current);
+
+    if (memcmp(&current, &binding, sizeof(binding)) == 0) {
         LOG_DBG("Not setting, no change to layer %d at index %d (%d)", layer_id, binding_idx,
                 storage_binding_idx);
         return 0;
     }
 
+    ret = keymap_store_binding(layer_id, storage_binding_idx, &binding);
+    if (ret < 0) {
+        return ret;
+    }
+
     uint8_t *pending = zmk_keymap_layer_pending_changes[layer_id];
 
     WRITE_BIT(pending[storage_binding_idx / 8], storage_binding_idx % 8, 1);
 
-    // TODO: Need a mutex to protect access to the keymap data?
-    memcpy(&zmk_keymap[layer_id][storage_binding_idx], &binding, sizeof(binding));
-
     return 0;
 }
 
@@ -458,6 +867,74 @@ struct zmk_behavior_binding_setting {
     uint32_t param2;
 } __packed;
 
+#define KEYMAP_STORAGE_VERSION 1
+
+// Each layer is stored as one blob: this header, a bitmap of the key positions whose binding
+// differs from the stock keymap, then the bindings of those positions in order.
+struct keymap_layer_blob_header {
+    uint8_t version;
+    uint16_t keymap_len;
+    // Of everything following the header
+    uint32_t crc;
+} __packed;
+
+#define LAYER_BLOB_MAX_SIZE                                                                        \
+    (sizeof(struct keymap_layer_blob_header) + PENDING_ARRAY_SIZE +                                \
+     ZMK_KEYMAP_LEN * sizeof(struct zmk_behavior_binding_setting))
+
+// Changes saved since the layer blobs were last written. Once full, it is folded into the blobs.
+struct keymap_journal_entry {
+    uint8_t layer;
+    uint8_t key_position;
+    struct zmk_behavior_binding_setting binding;
+} __packed;
+
+struct keymap_journal {
+    uint8_t version;
+    uint8_t len;
+    // Of the entries in use
+    uint32_t crc;
+    struct keymap_journal_entry entries[CONFIG_ZMK_KEYMAP_SETTINGS_JOURNAL_SIZE];
+} __packed;
+
+static struct keymap_journal journal = {.version = KEYMAP_STORAGE_VERSION};
+
+static uint8_t layer_blob_buf[LAYER_BLOB_MAX_SIZE];
+
+// Layers with bindings in the old one setting per binding format, to be moved into blobs
+static uint32_t legacy_binding_layers;
+
+// Whether the keymap was restored from a snapshot, see CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT
+static bool snapshot_loaded;
+
+static struct zmk_behavior_binding_setting
+binding_to_setting(const struct zmk_behavior_binding *binding) {
+    return (struct zmk_behavior_binding_setting){
+        .behavior_local_id = zmk_behavior_get_local_id(binding->behavior_dev),
+        .param1 = binding->param1,
+        .param2 = binding->param2,
+    };
+}
+
+static struct zmk_behavior_binding
+binding_from_setting(const struct zmk_behavior_binding_setting *setting) {
+    const char *name = zmk_behavior_find_behavior_name_from_local_id(setting->behavior_local_id);
+
+    if (!name) {
+        LOG_WRN("Loaded device %d from settings but no device found by that local ID",
+                setting->behavior_local_id);
+    }
+
+    return (struct zmk_behavior_binding){
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        .local_id = setting->behavior_local_id,
+#endif
+        .behavior_dev = name,
+        .param1 = setting->param1,
+        .param2 = setting->param2,
+    };
+}
+
 int zmk_keymap_check_unsaved_changes(void) {
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
         uint8_t *pending = zmk_keymap_layer_pending_changes[l];
@@ -480,73 +957,223 @@ int zmk_keymap_check_unsaved_changes(void) {
 #define LAYER_ORDER_SETTINGS_KEY "keymap/layer_order"
 #define LAYER_NAME_SETTINGS_KEY "keymap/l_n/%d"
 #define LAYER_BINDING_SETTINGS_KEY "keymap/l/%d/%d"
+#define LAYER_BLOB_SETTINGS_KEY "keymap/b/%d"
+#define JOURNAL_SETTINGS_KEY "keymap/j"
 
-static int save_bindings(void) {
-    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-        uint8_t *pending = zmk_keymap_layer_pending_changes[l];
+// Fills a bitmap of the positions of the layer that differ from the stock keymap, followed by
+// their bindings. Returns the number of bindings, or -ENOMEM if more than max_len differ.
+static int encode_customized_bindings(zmk_keymap_layer_id_t layer, uint8_t *customized,
+                                      struct zmk_behavior_binding_setting *bindings,
+                                      size_t max_len) {
+    size_t bindings_len = 0;
 
-        for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
-            if (pending[kp / 8] & BIT(kp % 8)) {
+    memset(customized, 0, PENDING_ARRAY_SIZE);
 
-                const struct zmk_behavior_binding *binding = &zmk_keymap[l][kp];
-                LOG_DBG("Pending save for layer %d at key position %d: %s with %d, %d", l, kp,
-                        binding->behavior_dev, binding->param1, binding->param2);
-
-                struct zmk_behavior_binding_setting binding_setting = {
-                    .behavior_local_id = zmk_behavior_get_local_id(binding->behavior_dev),
-                    .param1 = binding->param1,
-                    .param2 = binding->param2,
-                };
-
-                // We can skip any trailing zero params, regardless of the behavior
-                // and if those params are meaningful.
-                size_t len = sizeof(binding_setting);
-                if (binding_setting.param2 == 0) {
-                    len -= 4;
-
-                    if (binding_setting.param1 == 0) {
-                        len -= 4;
-                    }
-                }
+    for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+        struct zmk_behavior_binding binding;
+        keymap_binding_copy(layer, kp, &binding);
 
-                char setting_name[20];
-                sprintf(setting_name, LAYER_BINDING_SETTINGS_KEY, l, kp);
+        struct zmk_behavior_binding_setting setting = binding_to_setting(&binding);
+        struct zmk_behavior_binding_setting stock =
+            binding_to_setting(&zmk_stock_keymap[layer][kp]);
 
-                int ret = settings_save_one(setting_name, &binding_setting, len);
-                if (ret < 0) {
-                    LOG_ERR("Failed to save keymap binding at %d on layer %d (%d)", l, kp, ret);
-                    return ret;
-                }
+        if (memcmp(&setting, &stock, sizeof(setting)) == 0) {
+            continue;
+        }
 
-                WRITE_BIT(pending[kp / 8], kp % 8, 0);
-            }
+        if (bindings_len == max_len) {
+            return -ENOMEM;
         }
+
+        WRITE_BIT(customized[kp / 8], kp % 8, 1);
+        bindings[bindings_len++] = setting;
     }
 
-    return 0;
+    return bindings_len;
 }
 
-#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
-static int save_layer_orders(void) {
-    int ret = settings_save_one(LAYER_ORDER_SETTINGS_KEY, keymap_layer_orders,
-                                ARRAY_SIZE(keymap_layer_orders));
-    if (ret < 0) {
-        return ret;
+static size_t count_customized_bindings(const uint8_t *customized) {
+    size_t count = 0;
+
+    for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+        if (customized[kp / 8] & BIT(kp % 8)) {
+            count++;
+        }
     }
 
-    memcpy(settings_layer_orders, keymap_layer_orders, ARRAY_SIZE(keymap_layer_orders));
-    return 0;
+    return count;
 }
-#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
-static int save_layer_names(void) {
-    for (int id = 0; id < ZMK_KEYMAP_LAYERS_LEN; id++) {
-        if (changed_layer_names & BIT(id)) {
-            char setting_name[14];
-            sprintf(setting_name, LAYER_NAME_SETTINGS_KEY, id);
-            int ret = settings_save_one(setting_name, zmk_keymap_layer_names[id],
-                                        strlen(zmk_keymap_layer_names[id]));
-            if (ret < 0) {
+static void decode_customized_bindings(zmk_keymap_layer_id_t layer, const uint8_t *customized,
+                                       const struct zmk_behavior_binding_setting *bindings) {
+    for (int kp = 0, b = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+        if (customized[kp / 8] & BIT(kp % 8)) {
+            struct zmk_behavior_binding binding = binding_from_setting(&bindings[b++]);
+
+            if (keymap_store_binding(layer, kp, &binding) < 0) {
+                LOG_WRN("Failed to restore the binding of layer %d at %d", layer, kp);
+            }
+        }
+    }
+}
+
+static int save_layer_blob(zmk_keymap_layer_id_t layer) {
+    struct keymap_layer_blob_header *header = (struct keymap_layer_blob_header *)layer_blob_buf;
+    uint8_t *customized = layer_blob_buf + sizeof(*header);
+    struct zmk_behavior_binding_setting *bindings =
+        (struct zmk_behavior_binding_setting *)(customized + PENDING_ARRAY_SIZE);
+    size_t bindings_len = encode_customized_bindings(layer, customized, bindings, ZMK_KEYMAP_LEN);
+
+    char setting_name[14];
+    sprintf(setting_name, LAYER_BLOB_SETTINGS_KEY, layer);
+
+    if (bindings_len == 0) {
+        return settings_delete(setting_name);
+    }
+
+    size_t len = sizeof(*header) + PENDING_ARRAY_SIZE + bindings_len * sizeof(*bindings);
+
+    header->version = KEYMAP_STORAGE_VERSION;
+    header->keymap_len = ZMK_KEYMAP_LEN;
+    header->crc = crc32_ieee(customized, len - sizeof(*header));
+
+    LOG_DBG("Saving layer %d blob with %d bindings", layer, bindings_len);
+
+    return settings_save_one(setting_name, layer_blob_buf, len);
+}
+
+static int journal_add(uint8_t layer, uint8_t key_position,
+                       const struct zmk_behavior_binding_setting *binding) {
+    struct keymap_journal_entry *entry = NULL;
+
+    for (int i = 0; i < journal.len; i++) {
+        if (journal.entries[i].layer == layer && journal.entries[i].key_position == key_position) {
+            entry = &journal.entries[i];
+            break;
+        }
+    }
+
+    if (!entry) {
+        if (journal.len >= ARRAY_SIZE(journal.entries)) {
+            return -ENOSPC;
+        }
+
+        entry = &journal.entries[journal.len++];
+    }
+
+    *entry = (struct keymap_journal_entry){
+        .layer = layer,
+        .key_position = key_position,
+        .binding = *binding,
+    };
+
+    return 0;
+}
+
+static size_t journal_size(void) {
+    return offsetof(struct keymap_journal, entries) + journal.len * sizeof(journal.entries[0]);
+}
+
+static int save_journal(void) {
+    journal.version = KEYMAP_STORAGE_VERSION;
+    journal.crc = crc32_ieee((const uint8_t *)journal.entries,
+                             journal.len * sizeof(journal.entries[0]));
+
+    return settings_save_one(JOURNAL_SETTINGS_KEY, &journal, journal_size());
+}
+
+// Writes the blobs of the given layers and of every layer in the journal, then drops the journal
+static int compact_bindings(uint32_t layers) {
+    for (int i = 0; i < journal.len; i++) {
+        WRITE_BIT(layers, journal.entries[i].layer, 1);
+    }
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        if (!(layers & BIT(l))) {
+            continue;
+        }
+
+        int ret = save_layer_blob(l);
+        if (ret < 0) {
+            LOG_ERR("Failed to save keymap layer %d (%d)", l, ret);
+            return ret;
+        }
+    }
+
+    journal.len = 0;
+    return settings_delete(JOURNAL_SETTINGS_KEY);
+}
+
+static int save_bindings(void) {
+    uint32_t compact_layers = 0;
+    bool journal_changed = false;
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        uint8_t *pending = zmk_keymap_layer_pending_changes[l];
+
+        for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+            if (!(pending[kp / 8] & BIT(kp % 8))) {
+                continue;
+            }
+
+            struct zmk_behavior_binding binding;
+            keymap_binding_copy(l, kp, &binding);
+
+            LOG_DBG("Pending save for layer %d at key position %d: %s with %d, %d", l, kp,
+                    binding.behavior_dev, binding.param1, binding.param2);
+
+            struct zmk_behavior_binding_setting binding_setting = binding_to_setting(&binding);
+
+            // Once the journal is full, the whole layer is written out instead
+            if ((compact_layers & BIT(l)) || journal_add(l, kp, &binding_setting) < 0) {
+                WRITE_BIT(compact_layers, l, 1);
+                continue;
+            }
+
+            journal_changed = true;
+        }
+    }
+
+    int ret = 0;
+    if (compact_layers) {
+        ret = compact_bindings(compact_layers);
+    } else if (journal_changed) {
+        ret = save_journal();
+    }
+
+    if (ret < 0) {
+        LOG_ERR("Failed to save keymap bindings (%d)", ret);
+        return ret;
+    }
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        memset(zmk_keymap_layer_pending_changes[l], 0, PENDING_ARRAY_SIZE);
+    }
+
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+static int save_layer_orders(void) {
+    int ret = settings_save_one(LAYER_ORDER_SETTINGS_KEY, keymap_layer_orders,
+                                ARRAY_SIZE(keymap_layer_orders));
+    if (ret < 0) {
+        return ret;
+    }
+
+    memcpy(settings_layer_orders, keymap_layer_orders, ARRAY_SIZE(keymap_layer_orders));
+    return 0;
+}
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+
+static int save_layer_names(void) {
+    for (int id = 0; id < ZMK_KEYMAP_LAYERS_LEN; id++) {
+        if (changed_layer_names & BIT(id)) {
+            char setting_name[14];
+            sprintf(setting_name, LAYER_NAME_SETTINGS_KEY, id);
+            int ret = settings_save_one(setting_name, zmk_keymap_layer_names[id],
+                                        strlen(zmk_keymap_layer_names[id]));
+            if (ret < 0) {
                 return ret;
             }
         }
@@ -556,7 +1183,232 @@ static int save_layer_names(void) {
     return 0;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT)
+
+#define SNAPSHOT_SETTINGS_KEY "keymap/snap"
+
+// The snapshot holds everything the keymap settings resolve to: this header, the layer order,
+// the layer names, a bitmap per layer of the positions that differ from the stock keymap, then
+// the bindings of those positions. It is only valid for firmware with the same stock keymap.
+struct keymap_snapshot_header {
+    uint8_t version;
+    uint32_t stock_hash;
+    // Of everything following the header
+    uint32_t crc;
+} __packed;
+
+#define SNAPSHOT_LAYER_ORDERS_SIZE                                                                 \
+    COND_CODE_1(IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING), (ZMK_KEYMAP_LAYERS_LEN), (0))
+#define SNAPSHOT_FIXED_SIZE                                                                        \
+    (sizeof(struct keymap_snapshot_header) + SNAPSHOT_LAYER_ORDERS_SIZE +                          \
+     sizeof(zmk_keymap_layer_names) + ZMK_KEYMAP_LAYERS_LEN * PENDING_ARRAY_SIZE)
+
+static uint8_t snapshot_buf[CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT_MAX_SIZE];
+
+// Hash of everything the snapshot is relative to, taken before the settings are loaded
+static uint32_t stock_keymap_hash;
+
+// Length and CRC of the snapshot record in storage, to skip rewriting it unchanged
+static size_t stored_snapshot_len;
+static uint32_t stored_snapshot_crc;
+
+// Whether the keymap is known not to fit in a snapshot. This is stored as a snapshot record with
+// only a header, so boot doesn't try and fail to save the snapshot every time.
+static bool snapshot_unfit;
+
+static void delete_snapshot(void) {
+    settings_delete(SNAPSHOT_SETTINGS_KEY);
+    stored_snapshot_len = 0;
+    snapshot_unfit = false;
+}
+
+static int write_snapshot(void) {
+    struct keymap_snapshot_header *header = (struct keymap_snapshot_header *)snapshot_buf;
+    uint8_t *pos = snapshot_buf + sizeof(*header);
+
+    if (sizeof(snapshot_buf) < SNAPSHOT_FIXED_SIZE) {
+        LOG_WRN("Keymap snapshot needs at least %d bytes, the keymap will be replayed on boot",
+                (int)SNAPSHOT_FIXED_SIZE);
+        return -ENOSPC;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    memcpy(pos, keymap_layer_orders, sizeof(keymap_layer_orders));
+    pos += sizeof(keymap_layer_orders);
+#endif
+
+    memcpy(pos, zmk_keymap_layer_names, sizeof(zmk_keymap_layer_names));
+    pos += sizeof(zmk_keymap_layer_names);
+
+    uint8_t *customized = pos;
+    struct zmk_behavior_binding_setting *bindings =
+        (struct zmk_behavior_binding_setting *)(customized +
+                                                ZMK_KEYMAP_LAYERS_LEN * PENDING_ARRAY_SIZE);
+    size_t max_len = (snapshot_buf + sizeof(snapshot_buf) - (uint8_t *)bindings) /
+                     sizeof(struct zmk_behavior_binding_setting);
+    size_t bindings_len = 0;
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        int ret = encode_customized_bindings(l, &customized[l * PENDING_ARRAY_SIZE],
+                                             &bindings[bindings_len], max_len - bindings_len);
+        if (ret < 0) {
+            LOG_WRN("Keymap has too many changes for a snapshot, it will be replayed on boot");
+            return -ENOSPC;
+        }
+
+        bindings_len += ret;
+    }
+
+    size_t len = SNAPSHOT_FIXED_SIZE + bindings_len * sizeof(struct zmk_behavior_binding_setting);
+
+    header->version = KEYMAP_STORAGE_VERSION;
+    header->stock_hash = stock_keymap_hash;
+    header->crc = crc32_ieee(snapshot_buf + sizeof(*header), len - sizeof(*header));
+
+    uint32_t crc = crc32_ieee(snapshot_buf, len);
+    if (len == stored_snapshot_len && crc == stored_snapshot_crc) {
+        return 0;
+    }
+
+    int ret = settings_save_one(SNAPSHOT_SETTINGS_KEY, snapshot_buf, len);
+    if (ret < 0) {
+        return ret;
+    }
+
+    stored_snapshot_len = len;
+    stored_snapshot_crc = crc;
+    return 0;
+}
+
+static int save_snapshot(void) {
+    int ret = write_snapshot();
+    if (ret == 0 || snapshot_unfit) {
+        return ret;
+    }
+
+    struct keymap_snapshot_header header = {.version = KEYMAP_STORAGE_VERSION,
+                                            .stock_hash = stock_keymap_hash};
+
+    if (settings_save_one(SNAPSHOT_SETTINGS_KEY, &header, sizeof(header)) == 0) {
+        stored_snapshot_len = 0;
+        snapshot_unfit = true;
+    }
+
+    return ret;
+}
+
+static int load_snapshot(size_t len, settings_read_cb read_cb, void *cb_arg) {
+    struct keymap_snapshot_header *header = (struct keymap_snapshot_header *)snapshot_buf;
+
+    if (len == sizeof(*header)) {
+        int err = read_cb(cb_arg, header, len);
+        if (err < 0) {
+            LOG_ERR("Failed to read keymap snapshot from settings (err %d)", err);
+            return err;
+        }
+
+        // Only trusted for the stock keymap it was saved with, new firmware tries again
+        snapshot_unfit = header->version == KEYMAP_STORAGE_VERSION &&
+                         header->stock_hash == stock_keymap_hash;
+        return 0;
+    }
+
+    if (len < SNAPSHOT_FIXED_SIZE || len > sizeof(snapshot_buf)) {
+        LOG_WRN("Ignoring keymap snapshot of size %d", len);
+        return 0;
+    }
+
+    int err = read_cb(cb_arg, snapshot_buf, len);
+    if (err < (int)len) {
+        LOG_ERR("Failed to read keymap snapshot from settings (err %d)", err);
+        return 0;
+    }
+
+    stored_snapshot_len = len;
+    stored_snapshot_crc = crc32_ieee(snapshot_buf, len);
+
+    if (header->version != KEYMAP_STORAGE_VERSION || header->stock_hash != stock_keymap_hash) {
+        LOG_INF("Keymap snapshot is from a different keymap, replaying the keymap settings");
+        return 0;
+    }
+
+    if (header->crc != crc32_ieee(snapshot_buf + sizeof(*header), len - sizeof(*header))) {
+        LOG_ERR("Ignoring corrupted keymap snapshot");
+        return 0;
+    }
+
+    const uint8_t *pos = snapshot_buf + sizeof(*header);
+    const uint8_t *customized =
+        snapshot_buf + SNAPSHOT_FIXED_SIZE - ZMK_KEYMAP_LAYERS_LEN * PENDING_ARRAY_SIZE;
+    const struct zmk_behavior_binding_setting *bindings =
+        (const struct zmk_behavior_binding_setting *)(snapshot_buf + SNAPSHOT_FIXED_SIZE);
+    size_t customized_len = 0;
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        customized_len += count_customized_bindings(&customized[l * PENDING_ARRAY_SIZE]);
+    }
+
+    if (len - SNAPSHOT_FIXED_SIZE != customized_len * sizeof(*bindings)) {
+        LOG_ERR("Ignoring keymap snapshot with mismatched bindings");
+        return 0;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    memcpy(keymap_layer_orders, pos, sizeof(keymap_layer_orders));
+    memcpy(settings_layer_orders, pos, sizeof(settings_layer_orders));
+    pos += sizeof(keymap_layer_orders);
+#endif
+
+    memcpy(zmk_keymap_layer_names, pos, sizeof(zmk_keymap_layer_names));
+
+    // Records read before the snapshot may have changed the keymap already
+    reload_from_stock_keymap();
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        decode_customized_bindings(l, &customized[l * PENDING_ARRAY_SIZE], bindings);
+        bindings += count_customized_bindings(&customized[l * PENDING_ARRAY_SIZE]);
+    }
+
+    snapshot_loaded = true;
+    return 0;
+}
+
+// Bindings are hashed by behavior name rather than local ID, since the snapshot can be read before
+// the behavior local IDs are loaded
+static void hash_stock_keymap(void) {
+    uint32_t hash = 0;
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    hash = crc32_ieee_update(hash, keymap_layer_orders, sizeof(keymap_layer_orders));
+#endif
+
+    hash = crc32_ieee_update(hash, (const uint8_t *)zmk_keymap_layer_names,
+                             sizeof(zmk_keymap_layer_names));
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+            const struct zmk_behavior_binding *binding = &zmk_stock_keymap[l][kp];
+            const char *name = binding->behavior_dev ? binding->behavior_dev : "";
+
+            hash = crc32_ieee_update(hash, (const uint8_t *)name, strlen(name) + 1);
+            hash = crc32_ieee_update(hash, (const uint8_t *)&binding->param1,
+                                     sizeof(binding->param1));
+            hash = crc32_ieee_update(hash, (const uint8_t *)&binding->param2,
+                                     sizeof(binding->param2));
+        }
+    }
+
+    stock_keymap_hash = hash;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT)
+
 int zmk_keymap_save_changes(void) {
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT)
+    // Invalidate the snapshot first, so an interrupted save falls back to the records
+    delete_snapshot();
+#endif
+
     int ret = save_bindings();
     if (ret < 0) {
         return ret;
@@ -569,7 +1421,16 @@ int zmk_keymap_save_changes(void) {
     }
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
-    return save_layer_names();
+    ret = save_layer_names();
+    if (ret < 0) {
+        return ret;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT)
+    save_snapshot();
+#endif
+
+    return 0;
 }
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
@@ -589,17 +1450,11 @@ static void load_stock_keymap_layer_ordering() {
 }
 #endif
 
-static void reload_from_stock_keymap(void) {
-    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
-            zmk_keymap[l][k] = zmk_stock_keymap[l][k];
-        }
-    }
-}
-
 int zmk_keymap_discard_changes(void) {
     load_stock_keymap_layer_ordering();
     reload_from_stock_keymap();
+    journal.len = 0;
+    snapshot_loaded = false;
 
     int ret = settings_load_subtree("keymap");
     if (ret >= 0) {
@@ -638,35 +1493,85 @@ static int keymap_track_changed_bindings(const char *key, size_t len, settings_r
     return 0;
 }
 
-int zmk_keymap_reset_settings(void) {
-    settings_delete(LAYER_ORDER_SETTINGS_KEY);
+// Deletes the one setting per binding records of the given layers
+static void delete_legacy_bindings(uint32_t layers) {
+    uint8_t legacy_bindings[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE] = {0};
 
-    uint8_t zmk_keymap_layer_changes[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
-
-    settings_load_subtree_direct("keymap", keymap_track_changed_bindings,
-                                 &zmk_keymap_layer_changes);
+    settings_load_subtree_direct("keymap", keymap_track_changed_bindings, &legacy_bindings);
 
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-        char layer_name_setting_name[14];
-        sprintf(layer_name_setting_name, LAYER_NAME_SETTINGS_KEY, l);
-        settings_delete(layer_name_setting_name);
-
-        uint8_t *changes = zmk_keymap_layer_changes[l];
+        if (!(layers & BIT(l))) {
+            continue;
+        }
 
         for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
-            if (memcmp(&zmk_keymap[l][k], &zmk_stock_keymap[l][k],
-                       sizeof(struct zmk_behavior_binding_setting)) == 0) {
-                continue;
-            }
-
-            if (changes[k / 8] & BIT(k % 8)) {
-                LOG_WRN("CLEAR %d on %d layer", k, l);
+            if (legacy_bindings[l][k / 8] & BIT(k % 8)) {
                 char setting_name[20];
                 sprintf(setting_name, LAYER_BINDING_SETTINGS_KEY, l, k);
                 settings_delete(setting_name);
             }
         }
     }
+}
+
+static void migrate_legacy_bindings(void) {
+    uint32_t layers = legacy_binding_layers;
+
+    // The blobs are written before the old records are removed, so an interrupted migration is
+    // simply redone on the next boot
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        if (!(layers & BIT(l))) {
+            continue;
+        }
+
+        int ret = save_layer_blob(l);
+        if (ret < 0) {
+            LOG_ERR("Failed to migrate keymap layer %d bindings (%d)", l, ret);
+            return;
+        }
+    }
+
+    delete_legacy_bindings(layers);
+    legacy_binding_layers = 0;
+
+    LOG_INF("Migrated keymap bindings to layer blobs");
+}
+
+// Storage upkeep after loading, which can't write settings from within the settings load itself
+static void keymap_storage_upkeep(struct k_work *work) {
+    if (legacy_binding_layers) {
+        migrate_legacy_bindings();
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT)
+    if (!snapshot_loaded && !snapshot_unfit && save_snapshot() == 0) {
+        snapshot_loaded = true;
+    }
+#endif
+}
+
+static K_WORK_DEFINE(keymap_storage_upkeep_work, keymap_storage_upkeep);
+
+int zmk_keymap_reset_settings(void) {
+    settings_delete(LAYER_ORDER_SETTINGS_KEY);
+    settings_delete(JOURNAL_SETTINGS_KEY);
+    journal.len = 0;
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT)
+    delete_snapshot();
+    snapshot_loaded = false;
+#endif
+
+    delete_legacy_bindings(UINT32_MAX);
+    legacy_binding_layers = 0;
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        char setting_name[14];
+        sprintf(setting_name, LAYER_NAME_SETTINGS_KEY, l);
+        settings_delete(setting_name);
+
+        sprintf(setting_name, LAYER_BLOB_SETTINGS_KEY, l);
+        settings_delete(setting_name);
+    }
 
     load_stock_keymap_layer_ordering();
 
@@ -687,8 +1592,12 @@ int zmk_keymap_reset_settings(void) { return -ENOTSUP; }
 
 int zmk_keymap_apply_position_state(uint8_t source, zmk_keymap_layer_id_t layer_id,
                                     uint32_t position, bool pressed, int64_t timestamp) {
-    const struct zmk_behavior_binding *binding =
-        zmk_keymap_get_layer_binding_at_idx(layer_id, position);
+    struct zmk_behavior_binding binding;
+    int ret = zmk_keymap_get_layer_binding_copy(layer_id, position, &binding);
+    if (ret < 0) {
+        return ret;
+    }
+
     struct zmk_behavior_binding_event event = {
         .layer = layer_id,
         .position = position,
@@ -699,9 +1608,9 @@ int zmk_keymap_apply_position_state(uint8_t source, zmk_keymap_layer_id_t layer_
     };
 
     LOG_DBG("layer_id: %d position: %d, binding name: %s", layer_id, position,
-            binding->behavior_dev);
+            binding.behavior_dev);
 
-    return zmk_behavior_invoke_binding(binding, event, pressed);
+    return zmk_behavior_invoke_binding(&binding, event, pressed);
 }
 
 int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pressed,
@@ -827,11 +1736,101 @@ ZMK_SUBSCRIPTION(keymap, zmk_sensor_event);
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
+// Cycle count when the first keymap setting was read, to report how long loading took
+static uint32_t load_start;
+
+static int load_layer_blob(zmk_keymap_layer_id_t layer, size_t len, settings_read_cb read_cb,
+                           void *cb_arg) {
+    struct keymap_layer_blob_header *header = (struct keymap_layer_blob_header *)layer_blob_buf;
+    uint8_t *customized = layer_blob_buf + sizeof(*header);
+    struct zmk_behavior_binding_setting *bindings =
+        (struct zmk_behavior_binding_setting *)(customized + PENDING_ARRAY_SIZE);
+
+    if (len < sizeof(*header) + PENDING_ARRAY_SIZE || len > sizeof(layer_blob_buf)) {
+        LOG_ERR("Invalid size %d for keymap layer %d", len, layer);
+        return -EINVAL;
+    }
+
+    int err = read_cb(cb_arg, layer_blob_buf, len);
+    if (err < (int)len) {
+        LOG_ERR("Failed to read keymap layer %d from settings (err %d)", layer, err);
+        return err < 0 ? err : -EIO;
+    }
+
+    if (header->version != KEYMAP_STORAGE_VERSION || header->keymap_len != ZMK_KEYMAP_LEN) {
+        LOG_WRN("Ignoring keymap layer %d saved by an incompatible firmware", layer);
+        return -EINVAL;
+    }
+
+    if (header->crc != crc32_ieee(customized, len - sizeof(*header))) {
+        LOG_ERR("Ignoring corrupted keymap layer %d", layer);
+        return -EILSEQ;
+    }
+
+    size_t bindings_size = len - sizeof(*header) - PENDING_ARRAY_SIZE;
+    size_t customized_len = count_customized_bindings(customized);
+
+    if (bindings_size != customized_len * sizeof(*bindings)) {
+        LOG_ERR("Keymap layer %d has %d bytes of bindings for %d positions", layer, bindings_size,
+                customized_len);
+        return -EINVAL;
+    }
+
+    decode_customized_bindings(layer, customized, bindings);
+
+    return 0;
+}
+
+static int load_journal(size_t len, settings_read_cb read_cb, void *cb_arg) {
+    size_t header_len = offsetof(struct keymap_journal, entries);
+
+    journal.len = 0;
+
+    if (len < header_len || len > sizeof(journal)) {
+        LOG_ERR("Invalid keymap journal size %d", len);
+        return -EINVAL;
+    }
+
+    int err = read_cb(cb_arg, &journal, len);
+    if (err < (int)len) {
+        LOG_ERR("Failed to read keymap journal from settings (err %d)", err);
+        journal.len = 0;
+        return err < 0 ? err : -EIO;
+    }
+
+    if (journal.version != KEYMAP_STORAGE_VERSION || journal_size() != len ||
+        journal.crc != crc32_ieee((const uint8_t *)journal.entries,
+                                  journal.len * sizeof(journal.entries[0]))) {
+        LOG_ERR("Ignoring corrupted keymap journal");
+        journal.len = 0;
+        return -EILSEQ;
+    }
+
+    // Applied on commit, once all the layer blobs it builds upon are loaded
+    return 0;
+}
+
 static int keymap_handle_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
     const char *next;
 
     LOG_DBG("Setting Keymap setting %s", name);
 
+    if (load_start == 0) {
+        load_start = k_cycle_get_32();
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT)
+    if (settings_name_steq(name, "snap", &next) && !next) {
+        return load_snapshot(len, read_cb, cb_arg);
+    }
+
+    // The snapshot already holds what these records resolve to. The journal is still read, as
+    // later saves append to it.
+    if (snapshot_loaded && !settings_name_steq(name, "j", NULL)) {
+        return 0;
+    }
+#endif
+
     if (settings_name_steq(name, "l_n", &next) && next) {
         char *endptr;
         zmk_keymap_layer_id_t layer = strtoul(next, &endptr, 10);
@@ -891,22 +1890,30 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
             return err;
         }
 
-        const char *name =
-            zmk_behavior_find_behavior_name_from_local_id(binding_setting.behavior_local_id);
+        struct zmk_behavior_binding binding = binding_from_setting(&binding_setting);
 
-        if (!name) {
-            LOG_WRN("Loaded device %d from settings but no device found by that local ID",
-                    binding_setting.behavior_local_id);
+        err = keymap_store_binding(layer, key_position, &binding);
+        if (err < 0) {
+            return err;
         }
 
-        zmk_keymap[layer][key_position] = (struct zmk_behavior_binding){
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
-            .local_id = binding_setting.behavior_local_id,
-#endif
-            .behavior_dev = name,
-            .param1 = binding_setting.param1,
-            .param2 = binding_setting.param2,
-        };
+        WRITE_BIT(legacy_binding_layers, layer, 1);
+    } else if (settings_name_steq(name, "b", &next) && next) {
+        char *endptr;
+        uint8_t layer = strtoul(next, &endptr, 10);
+        if (*endptr != '\0') {
+            LOG_WRN("Invalid layer number: %s with endptr %s", next, endptr);
+            return -EINVAL;
+        }
+
+        if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+            LOG_WRN("Layer %d is larger than max of %d", layer, ZMK_KEYMAP_LAYERS_LEN);
+            return -EINVAL;
+        }
+
+        return load_layer_blob(layer, len, read_cb, cb_arg);
+    } else if (settings_name_steq(name, "j", &next) && !next) {
+        return load_journal(len, read_cb, cb_arg);
     }
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
     else if (settings_name_steq(name, "layer_order", &next) && !next) {
@@ -928,25 +1935,108 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
     return 0;
 };
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LOOKUP_BENCHMARK)
+
+#define LOOKUP_BENCHMARK_ROUNDS 16
+
+static volatile uint32_t lookup_benchmark_sink;
+
+// Times lookups of every binding through the same path key presses take, next to plain copies
+// out of the stock keymap as a baseline
+static void benchmark_lookups(void) {
+    const uint32_t lookups = LOOKUP_BENCHMARK_ROUNDS * ZMK_KEYMAP_LAYERS_LEN * ZMK_KEYMAP_LEN;
+    uint32_t start = k_cycle_get_32();
+
+    for (int r = 0; r < LOOKUP_BENCHMARK_ROUNDS; r++) {
+        for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+            for (int b = 0; b < ZMK_KEYMAP_LEN; b++) {
+                struct zmk_behavior_binding binding;
+
+                if (zmk_keymap_get_layer_binding_copy(l, b, &binding) == 0) {
+                    lookup_benchmark_sink += binding.param1;
+                }
+            }
+        }
+    }
+
+    uint32_t lookup_cycles = k_cycle_get_32() - start;
+    start = k_cycle_get_32();
+
+    for (int r = 0; r < LOOKUP_BENCHMARK_ROUNDS; r++) {
+        for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+            for (int b = 0; b < ZMK_KEYMAP_LEN; b++) {
+                struct zmk_behavior_binding binding = zmk_stock_keymap[l][b];
+
+                lookup_benchmark_sink += binding.param1;
+            }
+        }
+    }
+
+    uint32_t stock_cycles = k_cycle_get_32() - start;
+
+    LOG_INF("Keymap binding lookups take %u ns (%u ns for a stock binding copy)",
+            (uint32_t)(k_cyc_to_ns_floor64(lookup_cycles) / lookups),
+            (uint32_t)(k_cyc_to_ns_floor64(stock_cycles) / lookups));
+    LOG_INF("Keymap bindings use %u bytes of RAM (%u per binding, %u for a full binding)",
+            (uint32_t)KEYMAP_BINDINGS_SIZE,
+            (uint32_t)(KEYMAP_BINDINGS_SIZE / (ZMK_KEYMAP_LAYERS_LEN * ZMK_KEYMAP_LEN)),
+            (uint32_t)sizeof(struct zmk_behavior_binding));
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LOOKUP_BENCHMARK)
+
 static int keymap_handle_commit(void) {
+    // The snapshot already includes the journal
+    for (int i = 0; i < journal.len && !snapshot_loaded; i++) {
+        const struct keymap_journal_entry *entry = &journal.entries[i];
+
+        if (entry->layer >= ZMK_KEYMAP_LAYERS_LEN || entry->key_position >= ZMK_KEYMAP_LEN) {
+            LOG_WRN("Skipping keymap journal entry for layer %d at %d", entry->layer,
+                    entry->key_position);
+            continue;
+        }
+
+        struct zmk_behavior_binding binding = binding_from_setting(&entry->binding);
+
+        if (keymap_store_binding(entry->layer, entry->key_position, &binding) < 0) {
+            LOG_WRN("Failed to apply keymap journal entry for layer %d at %d", entry->layer,
+                    entry->key_position);
+        }
+    }
+
+    uint32_t load_cycles = load_start ? k_cycle_get_32() - load_start : 0;
+    LOG_INF("Keymap settings loaded in %u us%s", k_cyc_to_us_floor32(load_cycles),
+            snapshot_loaded ? " from snapshot" : "");
+    load_start = 0;
+
+    k_work_submit(&keymap_storage_upkeep_work);
+
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
         for (int p = 0; p < ZMK_KEYMAP_LEN; p++) {
-            struct zmk_behavior_binding *binding = &zmk_keymap[l][p];
+            struct zmk_behavior_binding resolved;
+            keymap_binding_copy(l, p, &resolved);
 
-            if (binding->local_id > 0 && !binding->behavior_dev) {
-                binding->behavior_dev =
-                    zmk_behavior_find_behavior_name_from_local_id(binding->local_id);
+            if (resolved.local_id > 0 && !resolved.behavior_dev) {
+                resolved.behavior_dev =
+                    zmk_behavior_find_behavior_name_from_local_id(resolved.local_id);
 
-                if (!binding->behavior_dev) {
+                if (!resolved.behavior_dev) {
                     LOG_ERR("Failed to finding device for local ID %d after settings load",
-                            binding->local_id);
+                            resolved.local_id);
+                    continue;
                 }
+
+                keymap_store_binding(l, p, &resolved);
             }
         }
     }
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LOOKUP_BENCHMARK)
+    benchmark_lookups();
+#endif
+
     return 0;
 }
 
@@ -962,6 +2052,9 @@ int keymap_init(void) {
 #if IS_ENABLED(CONFIG_ZMK_STUDIO)
     reload_from_stock_keymap();
 #endif
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_SNAPSHOT)
+    hash_stock_keymap();
+#endif
 
     return 0;
 }
@@ -24,7 +24,10 @@ int main(void) {
 
 #if IS_ENABLED(CONFIG_SETTINGS)
     settings_subsys_init();
+
+    int64_t settings_start = k_uptime_get();
     settings_load();
+    LOG_INF("Settings loaded in %lld ms", k_uptime_get() - settings_start);
 #endif
 
 #ifdef CONFIG_ZMK_DISPLAY
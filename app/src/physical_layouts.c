@@ -18,6 +18,7 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zmk/kscan_batch.h>
 #include <zmk/matrix.h>
 #include <zmk/physical_layouts.h>
 #include <zmk/event_manager.h>
@@ -171,6 +172,7 @@ struct zmk_kscan_event {
     uint32_t row;
     uint32_t column;
     uint32_t state;
+    int64_t timestamp;
 };
 
 static struct zmk_kscan_msg_processor {
@@ -180,43 +182,113 @@ static struct zmk_kscan_msg_processor {
 K_MSGQ_DEFINE(physical_layouts_kscan_msgq, sizeof(struct zmk_kscan_event),
               CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE, 4);
 
+// How long kscan drivers reporting from their own thread wait for room in a full queue
+#define KSCAN_ENQUEUE_TIMEOUT K_MSEC(100)
+
+// Events reported from the system work queue while the queue is full. The processing work runs on
+// the same queue, so it only makes room once the kscan driver is done with its scan. These events
+// are processed after the queued ones.
+static struct zmk_kscan_event kscan_overflow[CONFIG_ZMK_KSCAN_BATCH_SIZE];
+static size_t kscan_overflow_len;
+
+static void zmk_physical_layout_kscan_enqueue(uint32_t row, uint32_t column, bool pressed,
+                                              int64_t timestamp) {
+    struct zmk_kscan_event ev = {
+        .row = row,
+        .column = column,
+        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED),
+        .timestamp = timestamp};
+
+    if (k_is_in_isr()) {
+        if (k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT) != 0) {
+            LOG_WRN("Kscan event queue full, dropping event at %d,%d", row, column);
+        }
+        return;
+    }
+
+    if (k_current_get() == &k_sys_work_q.thread) {
+        // Once events are set aside, later ones go after them to keep their order.
+        if (kscan_overflow_len == 0 &&
+            k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT) == 0) {
+            return;
+        }
+
+        if (kscan_overflow_len < ARRAY_SIZE(kscan_overflow)) {
+            kscan_overflow[kscan_overflow_len++] = ev;
+        } else {
+            LOG_WRN("Kscan event queue full, dropping event at %d,%d", row, column);
+        }
+        return;
+    }
+
+    if (k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT) == 0) {
+        return;
+    }
+
+    // Let the processing work make room rather than racing it.
+    k_work_submit(&msg_processor.work);
+
+    if (k_msgq_put(&physical_layouts_kscan_msgq, &ev, KSCAN_ENQUEUE_TIMEOUT) != 0) {
+        LOG_WRN("Kscan event queue full, dropping event at %d,%d", row, column);
+    }
+}
+
 static void zmk_physical_layout_kscan_callback(const struct device *dev, uint32_t row,
                                                uint32_t column, bool pressed) {
     if (dev != active->kscan) {
         return;
     }
 
-    struct zmk_kscan_event ev = {
-        .row = row,
-        .column = column,
-        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED)};
+    zmk_physical_layout_kscan_enqueue(row, column, pressed, k_uptime_get());
+    k_work_submit(&msg_processor.work);
+}
+
+static void zmk_physical_layout_kscan_batch_callback(const struct device *dev,
+                                                     const struct zmk_kscan_batch_event *events,
+                                                     size_t len, int64_t timestamp) {
+    if (dev != active->kscan) {
+        return;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        zmk_physical_layout_kscan_enqueue(events[i].row, events[i].column, events[i].pressed,
+                                          timestamp);
+    }
 
-    k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT);
     k_work_submit(&msg_processor.work);
 }
 
+static void zmk_physical_layouts_kscan_process_event(const struct zmk_kscan_event *ev) {
+    bool pressed = (ev->state == ZMK_KSCAN_EVENT_STATE_PRESSED);
+    int32_t position = zmk_matrix_transform_row_column_to_position(active->matrix_transform,
+                                                                   ev->row, ev->column);
+
+    if (position < 0) {
+        LOG_WRN("Not found in transform: row: %d, col: %d, pressed: %s", ev->row, ev->column,
+                (pressed ? "true" : "false"));
+        return;
+    }
+
+    LOG_DBG("Row: %d, col: %d, position: %d, pressed: %s", ev->row, ev->column, position,
+            (pressed ? "true" : "false"));
+    raise_zmk_position_state_changed(
+        (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+                                            .state = pressed,
+                                            .position = position,
+                                            .timestamp = ev->timestamp});
+}
+
 static void zmk_physical_layouts_kscan_process_msgq(struct k_work *item) {
     struct zmk_kscan_event ev;
 
     while (k_msgq_get(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT) == 0) {
-        bool pressed = (ev.state == ZMK_KSCAN_EVENT_STATE_PRESSED);
-        int32_t position = zmk_matrix_transform_row_column_to_position(active->matrix_transform,
-                                                                       ev.row, ev.column);
-
-        if (position < 0) {
-            LOG_WRN("Not found in transform: row: %d, col: %d, pressed: %s", ev.row, ev.column,
-                    (pressed ? "true" : "false"));
-            continue;
-        }
+        zmk_physical_layouts_kscan_process_event(&ev);
+    }
 
-        LOG_DBG("Row: %d, col: %d, position: %d, pressed: %s", ev.row, ev.column, position,
-                (pressed ? "true" : "false"));
-        raise_zmk_position_state_changed(
-            (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
-                                                .state = pressed,
-                                                .position = position,
-                                                .timestamp = k_uptime_get()});
+    for (size_t i = 0; i < kscan_overflow_len; i++) {
+        zmk_physical_layouts_kscan_process_event(&kscan_overflow[i]);
     }
+    kscan_overflow_len = 0;
 }
 
 static const struct zmk_physical_layout *get_default_layout(void) {
@@ -289,7 +361,9 @@ int zmk_physical_layouts_select_layout(const struct zmk_physical_layout *dest_la
 #elif IS_ENABLED(CONFIG_PM_DEVICE)
         pm_device_action_run(active->kscan, PM_DEVICE_ACTION_RESUME);
 #endif
-        kscan_config(active->kscan, zmk_physical_layout_kscan_callback);
+        if (zmk_kscan_batch_config(active->kscan, zmk_physical_layout_kscan_batch_callback) < 0) {
+            kscan_config(active->kscan, zmk_physical_layout_kscan_callback);
+        }
         kscan_enable_callback(active->kscan);
     }
 
@@ -8,7 +8,6 @@
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
 
-#include <math.h>
 #include <stdlib.h>
 
 #include <zephyr/logging/log.h>
@@ -22,6 +21,8 @@
 #include <zmk/usb.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/activity_state_changed.h>
+#include <zmk/events/battery_state_changed.h>
+#include <zmk/events/position_state_changed.h>
 #include <zmk/events/usb_conn_state_changed.h>
 #include <zmk/workqueue.h>
 #if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
@@ -34,6 +35,11 @@
 #include <zmk/ble.h>
 #include <zmk/endpoints.h>
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE)
+#include <zmk/physical_layouts.h>
+#include <zmk/rgb_underglow_reactive.h>
+#endif
+
 #if ZMK_BLE_IS_CENTRAL
 #include <zmk/split/bluetooth/central.h>
 #else
@@ -70,6 +76,11 @@ enum rgb_underglow_effect {
     UNDERGLOW_EFFECT_KINESIS,
     UNDERGLOW_EFFECT_BATTERY,
     UNDERGLOW_EFFECT_TEST,
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE)
+    UNDERGLOW_EFFECT_REACTIVE,
+    UNDERGLOW_EFFECT_RIPPLE,
+    UNDERGLOW_EFFECT_HEATMAP,
+#endif
     UNDERGLOW_EFFECT_NUMBER // Used to track number of underglow effects
 };
 
@@ -78,6 +89,8 @@ struct rgb_underglow_state {
     uint8_t animation_speed;
     uint8_t current_effect;
     uint16_t animation_step;
+    // Uptime at which the effect clock started. Split peripherals share the central's clock.
+    int64_t animation_epoch;
     bool on;
     bool status_active;
     uint16_t status_animation_step;
@@ -88,10 +101,36 @@ static const struct device *led_strip;
 static struct led_rgb pixels[STRIP_NUM_PIXELS];
 static struct led_rgb status_pixels[STRIP_NUM_PIXELS];
 
+// Last frame pushed to the strip, so unchanged frames don't need another transfer
+static struct led_rgb strip_frame[STRIP_NUM_PIXELS];
+static bool strip_frame_valid;
+
+// Animated effects render a new frame every UNDERGLOW_FRAME_MS. Effects which only change in
+// response to a state change return SYS_FOREVER_MS and are re-rendered on demand.
+#define UNDERGLOW_FRAME_MS 25
+
 static struct rgb_underglow_state state;
 
 static struct zmk_periph_led led_data;
 
+// Frames elapsed on the effect clock. Time based effects render from this rather than from a
+// per-frame counter, so halves which share the clock stay in phase without further traffic.
+static uint32_t zmk_rgb_underglow_clock_frames(void) {
+    return (k_uptime_get() - state.animation_epoch) / UNDERGLOW_FRAME_MS;
+}
+
+static void zmk_rgb_underglow_reset_clock(void) {
+    state.animation_step = 0;
+    state.animation_epoch = k_uptime_get();
+}
+
+// Fill in the effect descriptor and clock sent to split peripherals
+static void zmk_rgb_underglow_sync_led_data(void) {
+    led_data.color = state.color;
+    led_data.speed = state.animation_speed;
+    led_data.clock = k_uptime_get() - state.animation_epoch;
+}
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE)
 static bool last_ble_state[2];
 #endif
@@ -117,52 +156,91 @@ static struct zmk_led_hsb hsb_scale_zero_max(struct zmk_led_hsb hsb) {
     return hsb;
 }
 
-static struct led_rgb hsb_to_rgb(struct zmk_led_hsb hsb) {
-    float r = 0, g = 0, b = 0;
-
-    uint8_t i = hsb.h / 60;
-    float v = hsb.b / ((float)BRT_MAX);
-    float s = hsb.s / ((float)SAT_MAX);
-    float f = hsb.h / ((float)HUE_MAX) * 6 - i;
-    float p = v * (1 - s);
-    float q = v * (1 - f * s);
-    float t = v * (1 - (1 - f) * s);
-
-    switch (i % 6) {
-    case 0:
-        r = v;
-        g = t;
-        b = p;
-        break;
-    case 1:
-        r = q;
-        g = v;
-        b = p;
-        break;
-    case 2:
-        r = p;
-        g = v;
-        b = t;
-        break;
-    case 3:
-        r = p;
-        g = q;
-        b = v;
-        break;
-    case 4:
-        r = t;
-        g = p;
-        b = v;
-        break;
-    case 5:
-        r = v;
-        g = p;
-        b = q;
-        break;
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_GAMMA_CORRECTION)
+// Perceptual correction of each 8-bit channel, gamma 2.2
+static const uint8_t gamma_table[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 11, 11,
+    11, 12, 12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19, 20, 20, 21, 22, 22, 23,
+    23, 24, 25, 25, 26, 26, 27, 28, 28, 29, 30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39,
+    40, 41, 42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61,
+    62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88,
+    89, 90, 91, 93, 94, 95, 97, 98, 99, 100, 102, 103, 105, 106, 107, 109, 110, 111, 113, 114, 116,
+    117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135, 137, 138, 140, 141, 143, 145,
+    146, 148, 149, 151, 153, 154, 156, 158, 159, 161, 163, 165, 166, 168, 170, 172, 173, 175, 177,
+    179, 181, 182, 184, 186, 188, 190, 192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213,
+    215, 217, 219, 221, 223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253,
+    255,
+};
+
+#define GAMMA(x) gamma_table[(x)]
+#else
+#define GAMMA(x) (x)
+#endif
+
+enum hsb_channel {
+    HSB_CHANNEL_V,
+    HSB_CHANNEL_P,
+    HSB_CHANNEL_Q,
+    HSB_CHANNEL_T,
+    HSB_CHANNEL_NUMBER,
+};
+
+// Which of the V, P, Q and T channels go to red, green and blue in each 60 degree hue sector
+static const uint8_t hsb_sector_channels[6][3] = {
+    {HSB_CHANNEL_V, HSB_CHANNEL_T, HSB_CHANNEL_P}, {HSB_CHANNEL_Q, HSB_CHANNEL_V, HSB_CHANNEL_P},
+    {HSB_CHANNEL_P, HSB_CHANNEL_V, HSB_CHANNEL_T}, {HSB_CHANNEL_P, HSB_CHANNEL_Q, HSB_CHANNEL_V},
+    {HSB_CHANNEL_T, HSB_CHANNEL_P, HSB_CHANNEL_V}, {HSB_CHANNEL_V, HSB_CHANNEL_P, HSB_CHANNEL_Q},
+};
+
+// Integer HSV to RGB conversion. The V and P channels only depend on saturation and brightness, so
+// they can be computed once for a whole buffer of pixels. Results are within 1 of the equivalent
+// floating point conversion.
+static struct led_rgb hsb_to_rgb_channels(uint8_t channels[HSB_CHANNEL_NUMBER], uint16_t h,
+                                          uint8_t s, uint32_t v) {
+    const uint32_t f = h % 60;
+    channels[HSB_CHANNEL_Q] = v * (SAT_MAX * 60 - f * s) / (BRT_MAX * SAT_MAX * 60);
+    channels[HSB_CHANNEL_T] = v * (SAT_MAX * 60 - (60 - f) * s) / (BRT_MAX * SAT_MAX * 60);
+
+    const uint8_t *sector = hsb_sector_channels[(h / 60) % 6];
+
+    return (struct led_rgb){
+        r : GAMMA(channels[sector[0]]),
+        g : GAMMA(channels[sector[1]]),
+        b : GAMMA(channels[sector[2]]),
+    };
+}
+
+/**
+ * Render a buffer of pixels which share a saturation and brightness. The hue of pixel i is
+ * (hsb.h + i * hue_step) % HUE_MAX, so a hue_step of 0 fills the buffer with a single color.
+ */
+static void hsb_to_rgb_fill(struct led_rgb *dest, size_t len, struct zmk_led_hsb hsb,
+                            uint16_t hue_step) {
+    const uint32_t v = 255 * hsb.b;
+    uint8_t channels[HSB_CHANNEL_NUMBER];
+
+    channels[HSB_CHANNEL_V] = v / BRT_MAX;
+    channels[HSB_CHANNEL_P] = v * (SAT_MAX - hsb.s) / (BRT_MAX * SAT_MAX);
+
+    if (hue_step == 0) {
+        const struct led_rgb rgb = hsb_to_rgb_channels(channels, hsb.h, hsb.s, v);
+        for (size_t i = 0; i < len; i++) {
+            dest[i] = rgb;
+        }
+        return;
     }
 
-    struct led_rgb rgb = {r : r * 255, g : g * 255, b : b * 255};
+    uint16_t h = hsb.h;
+    for (size_t i = 0; i < len; i++) {
+        dest[i] = hsb_to_rgb_channels(channels, h, hsb.s, v);
+        h = (h + hue_step) % HUE_MAX;
+    }
+}
 
+static struct led_rgb hsb_to_rgb(struct zmk_led_hsb hsb) {
+    struct led_rgb rgb;
+    hsb_to_rgb_fill(&rgb, 1, hsb, 0);
     return rgb;
 }
 
@@ -175,6 +253,25 @@ static struct led_rgb hsb_to_rgb(struct zmk_led_hsb hsb) {
         b : LED_RGB_SCALING_MULTIPLE * (((hex) & 0x0000FF) >> 0)                                   \
     })
 
+static void zmk_rgb_underglow_tick(struct k_work *work);
+
+K_WORK_DEFINE(underglow_tick_work, zmk_rgb_underglow_tick);
+
+static void zmk_rgb_underglow_tick_handler(struct k_timer *timer) {
+    if (!state.on && !state.status_active) {
+        return;
+    }
+
+    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &underglow_tick_work);
+}
+
+K_TIMER_DEFINE(underglow_tick, zmk_rgb_underglow_tick_handler, NULL);
+
+// Render a new frame as soon as possible, e.g. after a state change affecting a static effect
+static void zmk_rgb_underglow_request_frame(void) {
+    k_timer_start(&underglow_tick, K_NO_WAIT, K_NO_WAIT);
+}
+
 int zmk_rgb_underglow_set_periph(struct zmk_periph_led periph) {
     led_data = periph;
     if (!state.on && led_data.on)
@@ -183,63 +280,83 @@ int zmk_rgb_underglow_set_periph(struct zmk_periph_led periph) {
         zmk_rgb_underglow_off();
 
     state.current_effect = led_data.effect;
+    if (led_data.has_effect_params) {
+        state.color = led_data.color;
+        state.animation_speed = led_data.speed;
+        // Adopt the central's effect clock, so time based effects render in phase with it
+        state.animation_epoch = k_uptime_get() - led_data.clock;
+    }
+    zmk_rgb_underglow_request_frame();
     LOG_DBG("Update led_data %d %d %d", led_data.layer, led_data.indicators, led_data.on);
     return 0;
 }
 
-static void zmk_rgb_underglow_effect_solid(void) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(state.color));
-    }
+static int32_t zmk_rgb_underglow_effect_solid(void) {
+    hsb_to_rgb_fill(pixels, STRIP_NUM_PIXELS, hsb_scale_min_max(state.color), 0);
+
+    return SYS_FOREVER_MS;
 }
 
-static void zmk_rgb_underglow_effect_breathe(void) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.b = abs(state.animation_step - 1200) / 12;
+static int32_t zmk_rgb_underglow_effect_breathe(void) {
+    state.animation_step = (zmk_rgb_underglow_clock_frames() * state.animation_speed * 10) % 2400;
 
-        pixels[i] = hsb_to_rgb(hsb_scale_zero_max(hsb));
-    }
+    struct zmk_led_hsb hsb = state.color;
+    hsb.b = abs(state.animation_step - 1200) / 12;
 
-    state.animation_step += state.animation_speed * 10;
+    hsb_to_rgb_fill(pixels, STRIP_NUM_PIXELS, hsb_scale_zero_max(hsb), 0);
 
-    if (state.animation_step > 2400) {
-        state.animation_step = 0;
-    }
+    return UNDERGLOW_FRAME_MS;
 }
 
-static void zmk_rgb_underglow_effect_spectrum(void) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.h = state.animation_step;
+static int32_t zmk_rgb_underglow_effect_spectrum(void) {
+    state.animation_step = (zmk_rgb_underglow_clock_frames() * state.animation_speed) % HUE_MAX;
 
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(hsb));
-    }
+    struct zmk_led_hsb hsb = state.color;
+    hsb.h = state.animation_step;
 
-    state.animation_step += state.animation_speed;
-    state.animation_step = state.animation_step % HUE_MAX;
+    hsb_to_rgb_fill(pixels, STRIP_NUM_PIXELS, hsb_scale_min_max(hsb), 0);
+
+    return UNDERGLOW_FRAME_MS;
 }
 
-static void zmk_rgb_underglow_effect_swirl(void) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.h = (HUE_MAX / STRIP_NUM_PIXELS * i + state.animation_step) % HUE_MAX;
+static int32_t zmk_rgb_underglow_effect_swirl(void) {
+    state.animation_step = (zmk_rgb_underglow_clock_frames() * state.animation_speed * 2) % HUE_MAX;
 
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(hsb));
-    }
+    struct zmk_led_hsb hsb = state.color;
+    hsb.h = state.animation_step;
+
+    hsb_to_rgb_fill(pixels, STRIP_NUM_PIXELS, hsb_scale_min_max(hsb), HUE_MAX / STRIP_NUM_PIXELS);
 
-    state.animation_step += state.animation_speed * 2;
-    state.animation_step = state.animation_step % HUE_MAX;
+    return UNDERGLOW_FRAME_MS;
 }
 
 #if ZMK_BLE_IS_CENTRAL
 static struct k_work_delayable led_update_work;
+static bool peripheral_connected;
+
+static bool zmk_rgb_underglow_effect_uses_clock(void) {
+    return state.current_effect == UNDERGLOW_EFFECT_BREATHE ||
+           state.current_effect == UNDERGLOW_EFFECT_SPECTRUM ||
+           state.current_effect == UNDERGLOW_EFFECT_SWIRL;
+}
 
 static void zmk_rgb_underglow_central_send() {
+    zmk_rgb_underglow_sync_led_data();
     int err = zmk_split_bt_update_led(&led_data);
     if (err) {
         LOG_ERR("send failed (err %d)", err);
     }
+
+#if CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC_INTERVAL > 0
+    // Occasionally resend the clock to correct for drift between the halves' oscillators, which
+    // only shows while both halves are animating from it
+    if (state.on && peripheral_connected && zmk_rgb_underglow_effect_uses_clock()) {
+        k_work_reschedule(&led_update_work,
+                          K_SECONDS(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC_INTERVAL));
+    } else {
+        k_work_cancel_delayable(&led_update_work);
+    }
+#endif
 }
 
 #define NUM_BT_COLORS 4
@@ -248,6 +365,14 @@ static const struct led_rgb BT_COLORS[NUM_BT_COLORS] = {LED_RGB(0xFFFFFF), LED_R
                                                         LED_RGB(0xFF0000), LED_RGB(0x00FF00)};
 #endif
 
+// Render the new color or speed, and share it with split peripherals
+static void zmk_rgb_underglow_color_changed(void) {
+    zmk_rgb_underglow_request_frame();
+#if ZMK_BLE_IS_CENTRAL
+    zmk_rgb_underglow_central_send();
+#endif
+}
+
 static const struct led_rgb LAYER_COLORS[8] = {
     LED_RGB(0x000000), LED_RGB(0xFFFFFF), LED_RGB(0x0000FF), LED_RGB(0x00FF00),
     LED_RGB(0xFF0000), LED_RGB(0xFF00FF), LED_RGB(0x00FFFF), LED_RGB(0xFFFF00)};
@@ -286,7 +411,7 @@ static struct led_rgb zmk_get_indicator_color(zmk_hid_indicators_t bit) {
                                      : LED_RGB(0x000000);
 }
 
-static void zmk_rgb_underglow_effect_kinesis() {
+static int32_t zmk_rgb_underglow_effect_kinesis() {
 #if ZMK_BLE_IS_CENTRAL
     // update state and propagate to peripheral if necessary
     old_led_data.layer = led_data.layer;
@@ -417,21 +542,22 @@ static void zmk_rgb_underglow_effect_kinesis() {
             pixels[i] = color;
     }
 #endif
+
+    // Layer, indicator and connection state are polled, so keep ticking
+    return UNDERGLOW_FRAME_MS;
 }
 
-static void zmk_rgb_underglow_effect_test() {
+static int32_t zmk_rgb_underglow_effect_test() {
     triggered = true;
     struct led_rgb rgb;
     rgb.r = 0;
     rgb.g = 0;
     rgb.b = 0;
 
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.h = state.animation_step;
+    struct zmk_led_hsb test_hsb = state.color;
+    test_hsb.h = state.animation_step;
+    hsb_to_rgb_fill(pixels, STRIP_NUM_PIXELS, hsb_scale_min_max(test_hsb), 0);
 
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(hsb));
-    }
     if (state.animation_step < (HUE_MAX * 3)) {
         struct zmk_led_hsb hsb = state.color;
         hsb.h = state.animation_step;
@@ -469,9 +595,52 @@ static void zmk_rgb_underglow_effect_test() {
         rgb.b = 255;
         for (int i = 0; i < STRIP_NUM_PIXELS; i++)
             pixels[i] = rgb;
+
+        return SYS_FOREVER_MS;
+    }
+
+    return UNDERGLOW_FRAME_MS;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE)
+static void zmk_rgb_underglow_reactive_pixel(size_t pixel, uint8_t level) {
+    struct zmk_led_hsb hsb = state.color;
+
+    if (state.current_effect == UNDERGLOW_EFFECT_HEATMAP) {
+        // Cold keys are blue, hot keys are red
+        hsb.h = 240 - (240 * level) / UINT8_MAX;
+        hsb.s = SAT_MAX;
+        hsb.b = level > 0 ? hsb.b : 0;
+    } else {
+        hsb.b = (hsb.b * level) / UINT8_MAX;
     }
+
+    pixels[pixel] = hsb_to_rgb(hsb_scale_zero_max(hsb));
+}
+
+static int32_t zmk_rgb_underglow_effect_reactive(enum zmk_rgb_underglow_reactive_mode mode) {
+    if (state.animation_step == 0) {
+        // Only animating pixels are rendered, so start from a dark strip
+        memset(pixels, 0, sizeof(pixels));
+        zmk_rgb_underglow_reactive_reset();
+        state.animation_step = 1;
+    }
+
+    if (zmk_rgb_underglow_reactive_update(mode, k_uptime_get(),
+                                          zmk_rgb_underglow_reactive_pixel)) {
+        return UNDERGLOW_FRAME_MS;
+    }
+
+    return SYS_FOREVER_MS;
 }
 
+static bool zmk_rgb_underglow_effect_is_reactive(void) {
+    return state.current_effect == UNDERGLOW_EFFECT_REACTIVE ||
+           state.current_effect == UNDERGLOW_EFFECT_RIPPLE ||
+           state.current_effect == UNDERGLOW_EFFECT_HEATMAP;
+}
+#endif
+
 #define NUM_BATTERY_LEVELS 3
 
 static const uint8_t BATTERY_LEVELS[NUM_BATTERY_LEVELS] = {80, 50, 20};
@@ -479,7 +648,7 @@ static const uint8_t BATTERY_LEVELS[NUM_BATTERY_LEVELS] = {80, 50, 20};
 static const struct led_rgb BATTERY_COLORS[NUM_BATTERY_LEVELS + 1] = {
     LED_RGB(0x00FF00), LED_RGB(0xFFFF00), LED_RGB(0xFF8C00), LED_RGB(0xFF0000)};
 
-static void zmk_rgb_underglow_effect_battery() {
+static int32_t zmk_rgb_underglow_effect_battery() {
     uint8_t soc = zmk_battery_state_of_charge();
 
     int color = 0;
@@ -490,6 +659,9 @@ static void zmk_rgb_underglow_effect_battery() {
     for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
         pixels[i] = rgb;
     }
+
+    // Re-rendered when the battery state changes
+    return SYS_FOREVER_MS;
 }
 
 // RGB underglow status support
@@ -633,9 +805,8 @@ static int zmk_led_generate_status(void) {
         state.status_animation_step = 0;
         blend = 0;
         
-        // Turn off timer and external power if main underglow is off
+        // Turn off external power if main underglow is off. The tick stops rescheduling itself.
         if (!state.on) {
-            k_timer_stop(&underglow_tick);
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_EXT_POWER)
             if (ext_power != NULL) {
                 int rc = ext_power_disable(ext_power);
@@ -653,6 +824,26 @@ static int zmk_led_generate_status(void) {
 static int zmk_led_generate_status(void) { return 0; }
 #endif
 
+static void zmk_led_strip_update(const struct led_rgb *frame) {
+    if (strip_frame_valid && memcmp(strip_frame, frame, sizeof(strip_frame)) == 0) {
+        return;
+    }
+
+    static struct led_rgb strip_tx[STRIP_NUM_PIXELS];
+
+    // The driver may overwrite the buffer it is given. Send a copy so that the cached frame and
+    // the rendered pixels, which effects may update incrementally, stay intact.
+    memcpy(strip_frame, frame, sizeof(strip_frame));
+    memcpy(strip_tx, frame, sizeof(strip_tx));
+    strip_frame_valid = true;
+
+    int err = led_strip_update_rgb(led_strip, strip_tx, STRIP_NUM_PIXELS);
+    if (err < 0) {
+        LOG_ERR("Failed to update the RGB strip (%d)", err);
+        strip_frame_valid = false;
+    }
+}
+
 static void zmk_led_write_pixels(void) {
     static struct led_rgb led_buffer[STRIP_NUM_PIXELS];
     int bat_level = zmk_battery_state_of_charge();
@@ -665,10 +856,7 @@ static void zmk_led_write_pixels(void) {
 
     // Fast path: no status indicators, battery level OK
     if (blend == 0 && bat_level >= 20) {
-        int err = led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
-        if (err < 0) {
-            LOG_ERR("Failed to update the RGB strip (%d)", err);
-        }
+        zmk_led_strip_update(pixels);
         return;
     }
 
@@ -705,53 +893,63 @@ static void zmk_led_write_pixels(void) {
         }
     }
 
-    int err = led_strip_update_rgb(led_strip, led_buffer, STRIP_NUM_PIXELS);
-    if (err < 0) {
-        LOG_ERR("Failed to update the RGB strip (%d)", err);
-    }
+    zmk_led_strip_update(led_buffer);
 }
 
 static void zmk_rgb_underglow_tick(struct k_work *work) {
+    int32_t next_frame_ms = SYS_FOREVER_MS;
+
     switch (state.current_effect) {
     case UNDERGLOW_EFFECT_SOLID:
-        zmk_rgb_underglow_effect_solid();
+        next_frame_ms = zmk_rgb_underglow_effect_solid();
         break;
     case UNDERGLOW_EFFECT_BREATHE:
-        zmk_rgb_underglow_effect_breathe();
+        next_frame_ms = zmk_rgb_underglow_effect_breathe();
         break;
     case UNDERGLOW_EFFECT_SPECTRUM:
-        zmk_rgb_underglow_effect_spectrum();
+        next_frame_ms = zmk_rgb_underglow_effect_spectrum();
         break;
     case UNDERGLOW_EFFECT_SWIRL:
-        zmk_rgb_underglow_effect_swirl();
+        next_frame_ms = zmk_rgb_underglow_effect_swirl();
         break;
     case UNDERGLOW_EFFECT_KINESIS:
-        zmk_rgb_underglow_effect_kinesis();
+        next_frame_ms = zmk_rgb_underglow_effect_kinesis();
         break;
     case UNDERGLOW_EFFECT_BATTERY:
-        zmk_rgb_underglow_effect_battery();
+        next_frame_ms = zmk_rgb_underglow_effect_battery();
         break;
     case UNDERGLOW_EFFECT_TEST:
-        zmk_rgb_underglow_effect_test();
+        next_frame_ms = zmk_rgb_underglow_effect_test();
+        break;
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE)
+    case UNDERGLOW_EFFECT_REACTIVE:
+        next_frame_ms = zmk_rgb_underglow_effect_reactive(ZMK_RGB_UNDERGLOW_REACTIVE_FADE);
+        break;
+    case UNDERGLOW_EFFECT_RIPPLE:
+        next_frame_ms = zmk_rgb_underglow_effect_reactive(ZMK_RGB_UNDERGLOW_REACTIVE_RIPPLE);
+        break;
+    case UNDERGLOW_EFFECT_HEATMAP:
+        next_frame_ms = zmk_rgb_underglow_effect_reactive(ZMK_RGB_UNDERGLOW_REACTIVE_HEATMAP);
         break;
+#endif
     }
 
     // Call the blending function
     zmk_led_write_pixels();
-}
 
-K_WORK_DEFINE(underglow_tick_work, zmk_rgb_underglow_tick);
+    // The status overlay fades in and out, so it needs frames regardless of the effect
+    if (state.status_active) {
+        next_frame_ms = next_frame_ms == SYS_FOREVER_MS ? UNDERGLOW_FRAME_MS
+                                                        : MIN(next_frame_ms, UNDERGLOW_FRAME_MS);
+    }
 
-static void zmk_rgb_underglow_tick_handler(struct k_timer *timer) {
-    if (!state.on && !state.status_active) {
+    if ((!state.on && !state.status_active) || next_frame_ms == SYS_FOREVER_MS) {
         return;
     }
 
-    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &underglow_tick_work);
+    k_timer_start(&underglow_tick, K_MSEC(next_frame_ms), K_NO_WAIT);
 }
 
-K_TIMER_DEFINE(underglow_tick, zmk_rgb_underglow_tick_handler, NULL);
-
 int zmk_rgb_underglow_save_state(void) { return 0; }
 
 static int zmk_rgb_underglow_init(void) {
@@ -815,8 +1013,10 @@ int zmk_rgb_underglow_on(void) {
 #endif
 
     state.on = true;
-    state.animation_step = 0;
-    k_timer_start(&underglow_tick, K_NO_WAIT, K_MSEC(25));
+    zmk_rgb_underglow_reset_clock();
+    // The strip may have lost power while off, so don't trust the last frame sent to it
+    strip_frame_valid = false;
+    zmk_rgb_underglow_request_frame();
 
 #if ZMK_BLE_IS_CENTRAL
     led_data.on = true;
@@ -831,7 +1031,7 @@ static void zmk_rgb_underglow_off_handler(struct k_work *work) {
         pixels[i] = (struct led_rgb){r : 0, g : 0, b : 0};
     }
 
-    led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
+    zmk_led_strip_update(pixels);
 }
 
 K_WORK_DEFINE(underglow_off_work, zmk_rgb_underglow_off_handler);
@@ -873,7 +1073,8 @@ int zmk_rgb_underglow_select_effect(int effect) {
     }
 
     state.current_effect = effect;
-    state.animation_step = 0;
+    zmk_rgb_underglow_reset_clock();
+    zmk_rgb_underglow_request_frame();
 
 #if ZMK_BLE_IS_CENTRAL
     led_data.effect = effect;
@@ -898,6 +1099,7 @@ int zmk_rgb_underglow_set_hsb(struct zmk_led_hsb color) {
     }
 
     state.color = color;
+    zmk_rgb_underglow_color_changed();
 
     return 0;
 }
@@ -939,6 +1141,7 @@ int zmk_rgb_underglow_change_hue(int direction) {
         return -ENODEV;
 
     state.color = zmk_rgb_underglow_calc_hue(direction);
+    zmk_rgb_underglow_color_changed();
 
     return zmk_rgb_underglow_save_state();
 }
@@ -948,6 +1151,7 @@ int zmk_rgb_underglow_change_sat(int direction) {
         return -ENODEV;
 
     state.color = zmk_rgb_underglow_calc_sat(direction);
+    zmk_rgb_underglow_color_changed();
 
     return zmk_rgb_underglow_save_state();
 }
@@ -957,6 +1161,7 @@ int zmk_rgb_underglow_change_brt(int direction) {
         return -ENODEV;
 
     state.color = zmk_rgb_underglow_calc_brt(direction);
+    zmk_rgb_underglow_color_changed();
 
     return zmk_rgb_underglow_save_state();
 }
@@ -969,12 +1174,18 @@ int zmk_rgb_underglow_change_spd(int direction) {
         return 0;
     }
 
+    uint8_t old_speed = state.animation_speed;
     state.animation_speed += direction;
 
     if (state.animation_speed > 5) {
         state.animation_speed = 5;
     }
 
+    // Rebase the clock so time based effects continue from the same phase at the new speed
+    int64_t now = k_uptime_get();
+    state.animation_epoch = now - (now - state.animation_epoch) * old_speed / state.animation_speed;
+    zmk_rgb_underglow_color_changed();
+
     return zmk_rgb_underglow_save_state();
 }
 
@@ -1026,6 +1237,7 @@ static int rgb_underglow_event_listener(const zmk_event_t *eh) {
 #endif
         led_data.layer = zmk_keymap_highest_layer_active();
         led_data.on = state.on;
+        zmk_rgb_underglow_sync_led_data();
         int err = zmk_split_bt_update_led(&led_data);
         if (err) {
             LOG_ERR("send failed (err %d)", err);
@@ -1035,11 +1247,34 @@ static int rgb_underglow_event_listener(const zmk_event_t *eh) {
     }
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE)
+    const struct zmk_position_state_changed *pos_ev = as_zmk_position_state_changed(eh);
+    if (pos_ev) {
+        if (pos_ev->state && state.on && zmk_rgb_underglow_effect_is_reactive()) {
+            zmk_rgb_underglow_reactive_press(pos_ev->position);
+            zmk_rgb_underglow_request_frame();
+        }
+        return 0;
+    }
+
+    if (as_zmk_physical_layout_selection_changed(eh)) {
+        zmk_rgb_underglow_reactive_layout_changed();
+        return 0;
+    }
+#endif
+
+    if (as_zmk_battery_state_changed(eh)) {
+        // Battery level affects the battery effect and low battery dimming of every effect
+        zmk_rgb_underglow_request_frame();
+        return 0;
+    }
+
 #if ZMK_BLE_IS_CENTRAL
     if (as_zmk_split_peripheral_status_changed(eh)) {
         LOG_DBG("event called");
         const struct zmk_split_peripheral_status_changed *ev;
         ev = as_zmk_split_peripheral_status_changed(eh);
+        peripheral_connected = ev->connected;
         if (ev->connected) {
             k_work_reschedule(&led_update_work, K_MSEC(2500));
             return 0;
@@ -1056,6 +1291,13 @@ static int rgb_underglow_event_listener(const zmk_event_t *eh) {
 ZMK_LISTENER(rgb_underglow, rgb_underglow_event_listener);
 // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_AUTO_OFF_USB)
 
+ZMK_SUBSCRIPTION(rgb_underglow, zmk_battery_state_changed);
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE)
+ZMK_SUBSCRIPTION(rgb_underglow, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(rgb_underglow, zmk_physical_layout_selection_changed);
+#endif
+
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_AUTO_OFF_IDLE)
 ZMK_SUBSCRIPTION(rgb_underglow, zmk_activity_state_changed);
 #endif
@@ -1075,10 +1317,11 @@ int zmk_rgb_underglow_status(void) {
     state.status_active = true;
     state.status_animation_step = 0;
     
-    // Ensure timer is running for status animation
+    // Ensure frames are rendered for the status animation
     if (!state.on) {
-        k_timer_start(&underglow_tick, K_NO_WAIT, K_MSEC(25));
+        strip_frame_valid = false;
     }
+    zmk_rgb_underglow_request_frame();
     
     // Enable external power if needed
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_EXT_POWER)
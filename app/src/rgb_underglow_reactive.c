@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/matrix.h>
+#include <zmk/physical_layouts.h>
+#include <zmk/rgb_underglow_reactive.h>
+
+#define DT_DRV_COMPAT zmk_underglow_key_map
+
+#define STRIP_CHOSEN DT_CHOSEN(zmk_underglow)
+#define STRIP_NUM_PIXELS DT_PROP(STRIP_CHOSEN, chain_length)
+
+#define NO_PIXEL UINT8_MAX
+
+BUILD_ASSERT(STRIP_NUM_PIXELS < NO_PIXEL, "Reactive underglow supports up to 254 pixels");
+BUILD_ASSERT(DT_INST_PROP_LEN(0, positions) == STRIP_NUM_PIXELS,
+             "The underglow key map must have one position per pixel of the underglow strip");
+
+// Decay rates, in levels per 100ms
+#define FADE_DECAY 50
+#define RIPPLE_DECAY 120
+#define HEATMAP_DECAY 4
+
+#define HEATMAP_PRESS_HEAT 64
+
+#define PRESS_QUEUE_SIZE 8
+
+#define MAX_NEIGHBORS CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE_NEIGHBORS
+
+// Key position of the default physical layout under each pixel
+static const uint8_t pixel_positions[] = DT_INST_PROP(0, positions);
+
+struct reactive_neighbor {
+    uint8_t pixel;
+    // In tenths of a key unit
+    uint8_t distance;
+};
+
+// Nearest pixels to each pixel, sorted by distance
+static struct reactive_neighbor neighbors[STRIP_NUM_PIXELS][MAX_NEIGHBORS];
+static uint8_t neighbors_len[STRIP_NUM_PIXELS];
+
+// Pixel under each key position of the selected physical layout
+static uint8_t position_pixels[ZMK_KEYMAP_LEN];
+
+static uint8_t levels[STRIP_NUM_PIXELS];
+static bool pixel_active[STRIP_NUM_PIXELS];
+static uint8_t active_pixels[STRIP_NUM_PIXELS];
+static size_t active_len;
+static int64_t last_update;
+
+struct reactive_ripple {
+    int64_t start;
+    uint8_t origin;
+    // Index of the next neighbor of the origin the ripple front will reach
+    uint8_t next;
+    bool active;
+};
+
+static struct reactive_ripple ripples[CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE_RIPPLES];
+
+K_MSGQ_DEFINE(reactive_presses, sizeof(uint32_t), PRESS_QUEUE_SIZE, 4);
+
+static atomic_t tables_dirty = ATOMIC_INIT(1);
+
+static uint32_t isqrt(uint32_t n) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > n) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+static void reactive_add_neighbor(uint8_t pixel, uint8_t neighbor, uint8_t distance) {
+    struct reactive_neighbor *list = neighbors[pixel];
+    uint8_t len = neighbors_len[pixel];
+
+    if (len == MAX_NEIGHBORS) {
+        if (distance >= list[len - 1].distance) {
+            return;
+        }
+        len--;
+    }
+
+    int i = len;
+    for (; i > 0 && list[i - 1].distance > distance; i--) {
+        list[i] = list[i - 1];
+    }
+
+    list[i] = (struct reactive_neighbor){.pixel = neighbor, .distance = distance};
+    neighbors_len[pixel] = len + 1;
+}
+
+// Pixels are placed at the center of their key. Key rotation is not taken into account.
+static void reactive_build_tables(void) {
+    static int32_t pixel_x[STRIP_NUM_PIXELS];
+    static int32_t pixel_y[STRIP_NUM_PIXELS];
+    static bool pixel_placed[STRIP_NUM_PIXELS];
+
+    const struct zmk_key_physical_attrs *keys = NULL;
+    size_t keys_len = 0;
+
+    struct zmk_physical_layout const *const *layouts;
+    size_t layouts_len = zmk_physical_layouts_get_list(&layouts);
+    int selected = zmk_physical_layouts_get_selected();
+    if (selected >= 0 && selected < layouts_len) {
+        keys = layouts[selected]->keys;
+        keys_len = layouts[selected]->keys_len;
+    }
+
+    const uint32_t *pos_map;
+    int pos_map_len = zmk_physical_layouts_get_selected_to_stock_position_map(&pos_map);
+    if (pos_map_len < 0) {
+        LOG_WRN("Failed to get the position map for reactive underglow (%d)", pos_map_len);
+        pos_map_len = 0;
+    }
+
+    memset(position_pixels, NO_PIXEL, sizeof(position_pixels));
+    memset(pixel_placed, 0, sizeof(pixel_placed));
+    memset(neighbors_len, 0, sizeof(neighbors_len));
+
+    for (int pos = 0; pos < MIN(pos_map_len, ZMK_KEYMAP_LEN); pos++) {
+        for (int p = 0; p < STRIP_NUM_PIXELS; p++) {
+            if (pixel_positions[p] != pos_map[pos]) {
+                continue;
+            }
+
+            position_pixels[pos] = p;
+            if (pos < keys_len) {
+                pixel_x[p] = keys[pos].x + keys[pos].width / 2;
+                pixel_y[p] = keys[pos].y + keys[pos].height / 2;
+                pixel_placed[p] = true;
+            }
+            break;
+        }
+    }
+
+    for (int p = 0; p < STRIP_NUM_PIXELS; p++) {
+        if (!pixel_placed[p]) {
+            continue;
+        }
+
+        for (int q = 0; q < STRIP_NUM_PIXELS; q++) {
+            if (q == p || !pixel_placed[q]) {
+                continue;
+            }
+
+            uint32_t dx = abs(pixel_x[p] - pixel_x[q]);
+            uint32_t dy = abs(pixel_y[p] - pixel_y[q]);
+            uint32_t distance = isqrt(dx * dx + dy * dy);
+            if (distance > CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE_RADIUS) {
+                continue;
+            }
+
+            reactive_add_neighbor(p, q, MIN(distance / 10, UINT8_MAX));
+        }
+    }
+}
+
+static void reactive_set_level(uint8_t pixel, uint8_t level) {
+    if (level == 0) {
+        return;
+    }
+
+    levels[pixel] = level;
+    if (!pixel_active[pixel]) {
+        pixel_active[pixel] = true;
+        active_pixels[active_len++] = pixel;
+    }
+}
+
+static void reactive_add_heat(uint8_t pixel, uint8_t heat) {
+    reactive_set_level(pixel, MIN(levels[pixel] + heat, UINT8_MAX));
+}
+
+static void reactive_start_ripple(uint8_t origin, int64_t now) {
+    struct reactive_ripple *ripple = &ripples[0];
+
+    // Replace the oldest ripple if they are all in use
+    for (int i = 0; i < ARRAY_SIZE(ripples); i++) {
+        if (!ripples[i].active) {
+            ripple = &ripples[i];
+            break;
+        }
+
+        if (ripples[i].start < ripple->start) {
+            ripple = &ripples[i];
+        }
+    }
+
+    *ripple = (struct reactive_ripple){.start = now, .origin = origin, .next = 0, .active = true};
+}
+
+static void reactive_apply_press(enum zmk_rgb_underglow_reactive_mode mode, uint8_t pixel,
+                                 int64_t now) {
+    switch (mode) {
+    case ZMK_RGB_UNDERGLOW_REACTIVE_HEATMAP:
+        reactive_add_heat(pixel, HEATMAP_PRESS_HEAT);
+        for (int i = 0; i < neighbors_len[pixel]; i++) {
+            reactive_add_heat(neighbors[pixel][i].pixel, HEATMAP_PRESS_HEAT / 4);
+        }
+        break;
+    case ZMK_RGB_UNDERGLOW_REACTIVE_RIPPLE:
+        reactive_set_level(pixel, UINT8_MAX);
+        reactive_start_ripple(pixel, now);
+        break;
+    default:
+        reactive_set_level(pixel, UINT8_MAX);
+        break;
+    }
+}
+
+static bool reactive_advance_ripples(int64_t now) {
+    bool active = false;
+
+    for (int i = 0; i < ARRAY_SIZE(ripples); i++) {
+        struct reactive_ripple *ripple = &ripples[i];
+        if (!ripple->active) {
+            continue;
+        }
+
+        const struct reactive_neighbor *list = neighbors[ripple->origin];
+        int64_t reached = (now - ripple->start) * CONFIG_ZMK_RGB_UNDERGLOW_REACTIVE_RIPPLE_SPEED /
+                          MSEC_PER_SEC;
+
+        // Neighbors are sorted by distance, so only the ones at the ripple front are visited
+        for (; ripple->next < neighbors_len[ripple->origin] &&
+               list[ripple->next].distance * 10 <= reached;
+             ripple->next++) {
+            reactive_set_level(list[ripple->next].pixel, UINT8_MAX);
+        }
+
+        ripple->active = ripple->next < neighbors_len[ripple->origin];
+        active |= ripple->active;
+    }
+
+    return active;
+}
+
+int zmk_rgb_underglow_reactive_press(uint32_t position) {
+    return k_msgq_put(&reactive_presses, &position, K_NO_WAIT);
+}
+
+void zmk_rgb_underglow_reactive_layout_changed(void) { atomic_set(&tables_dirty, 1); }
+
+void zmk_rgb_underglow_reactive_reset(void) {
+    k_msgq_purge(&reactive_presses);
+
+    memset(levels, 0, sizeof(levels));
+    memset(pixel_active, 0, sizeof(pixel_active));
+    active_len = 0;
+
+    for (int i = 0; i < ARRAY_SIZE(ripples); i++) {
+        ripples[i].active = false;
+    }
+}
+
+bool zmk_rgb_underglow_reactive_update(enum zmk_rgb_underglow_reactive_mode mode, int64_t now,
+                                       zmk_rgb_underglow_reactive_pixel_cb cb) {
+    if (atomic_cas(&tables_dirty, 1, 0)) {
+        reactive_build_tables();
+    }
+
+    int32_t decay_rate;
+    switch (mode) {
+    case ZMK_RGB_UNDERGLOW_REACTIVE_HEATMAP:
+        decay_rate = HEATMAP_DECAY;
+        break;
+    case ZMK_RGB_UNDERGLOW_REACTIVE_RIPPLE:
+        decay_rate = RIPPLE_DECAY;
+        break;
+    default:
+        decay_rate = FADE_DECAY;
+        break;
+    }
+
+    int64_t elapsed = active_len > 0 ? now - last_update : 0;
+    uint8_t decay = MIN(elapsed * decay_rate / 100, UINT8_MAX);
+    last_update = now;
+
+    uint32_t position;
+    while (k_msgq_get(&reactive_presses, &position, K_NO_WAIT) == 0) {
+        if (position >= ZMK_KEYMAP_LEN || position_pixels[position] == NO_PIXEL) {
+            continue;
+        }
+
+        reactive_apply_press(mode, position_pixels[position], now);
+    }
+
+    bool rippling = reactive_advance_ripples(now);
+
+    for (size_t i = 0; i < active_len;) {
+        uint8_t pixel = active_pixels[i];
+
+        cb(pixel, levels[pixel]);
+
+        // A pixel leaves the active list once its final, unlit frame has been reported
+        if (levels[pixel] == 0) {
+            pixel_active[pixel] = false;
+            active_pixels[i] = active_pixels[--active_len];
+            continue;
+        }
+
+        levels[pixel] = levels[pixel] > decay ? levels[pixel] - decay : 0;
+        i++;
+    }
+
+    return active_len > 0 || rippling;
+}
@@ -1230,7 +1230,12 @@ int zmk_split_bt_update_led(struct zmk_periph_led *periph) {
     struct zmk_split_update_led_data payload = {.layer = periph->layer,
                                                 .indicators = periph->indicators,
                                                 .effect = periph->effect,
-                                                .on = periph->on};
+                                                .on = periph->on,
+                                                .hue = periph->color.h,
+                                                .saturation = periph->color.s,
+                                                .brightness = periph->color.b,
+                                                .speed = periph->speed,
+                                                .clock = periph->clock};
 
     return split_bt_update_led_payload(payload);
 }
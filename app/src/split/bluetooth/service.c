@@ -84,16 +84,29 @@ static ssize_t split_svc_update_led(struct bt_conn *conn, const struct bt_gatt_a
 
     LOG_DBG("offset %d len %d", offset, len);
 
+    if (end_addr > sizeof(struct zmk_split_update_led_data)) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+
     memcpy(payload + offset, buf, len);
 
     // We run if:
     // 1: We've gotten all the position/state/param data.
-    // 2: We have a null terminated string for the behavior device label.
-    if ((end_addr == sizeof(struct zmk_split_update_led_data))) {
+    // 2: We've gotten the shorter payload of a central running older firmware, which leaves the
+    //    color, speed and clock unchanged.
+    const bool has_effect_params = end_addr == sizeof(struct zmk_split_update_led_data);
+    if (has_effect_params || end_addr == ZMK_SPLIT_UPDATE_LED_DATA_LEGACY_SIZE) {
         struct zmk_periph_led periph = {.layer = payload->layer,
                                         .indicators = payload->indicators,
                                         .effect = payload->effect,
                                         .on = payload->on};
+        if (has_effect_params) {
+            periph.color = (struct zmk_led_hsb){
+                .h = payload->hue, .s = payload->saturation, .b = payload->brightness};
+            periph.speed = payload->speed;
+            periph.clock = payload->clock;
+            periph.has_effect_params = true;
+        }
         zmk_rgb_underglow_set_periph(periph);
         LOG_DBG("Update leds with params %d and %d", periph.layer, periph.indicators);
     }
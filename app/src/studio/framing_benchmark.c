@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/ring_buffer.h>
+
+#include <string.h>
+
+#if IS_ENABLED(CONFIG_ARCH_POSIX)
+#include <native_rtc.h>
+#endif
+
+LOG_MODULE_DECLARE(zmk_studio, CONFIG_ZMK_STUDIO_LOG_LEVEL);
+
+#include "msg_framing.h"
+
+#define BENCHMARK_FRAMES 32
+#define BENCHMARK_ROUNDS 64
+
+// Worst case of every payload byte needing an escape, plus SOF and EOF
+#define BENCHMARK_STREAM_SIZE (BENCHMARK_FRAMES * (2 * UINT8_MAX + 2))
+
+static uint8_t stream[BENCHMARK_STREAM_SIZE];
+static uint8_t payload_by_byte[BENCHMARK_STREAM_SIZE];
+static uint8_t payload_by_span[BENCHMARK_STREAM_SIZE];
+static uint8_t payload_by_ring[BENCHMARK_STREAM_SIZE];
+
+// The same size as the RPC RX buffer, so frames wrap around it as they do there
+RING_BUF_DECLARE(benchmark_ring, CONFIG_ZMK_STUDIO_RPC_RX_BUF_SIZE);
+
+struct decode_result {
+    size_t payload_len;
+    int frames;
+    uint32_t calls;
+};
+
+static uint32_t next_random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Frames of random payloads, so about one byte in 85 needs to be escaped
+static size_t build_stream(void) {
+    uint32_t random = 0x5eed;
+    size_t len = 0;
+
+    for (int f = 0; f < BENCHMARK_FRAMES; f++) {
+        size_t payload_len = 32 + next_random(&random) % (UINT8_MAX - 32);
+
+        stream[len++] = FRAMING_SOF;
+        for (size_t i = 0; i < payload_len; i++) {
+            uint8_t b = next_random(&random);
+
+            if (b == FRAMING_SOF || b == FRAMING_ESC || b == FRAMING_EOF) {
+                stream[len++] = FRAMING_ESC;
+            }
+
+            stream[len++] = b;
+        }
+        stream[len++] = FRAMING_EOF;
+    }
+
+    return len;
+}
+
+static struct decode_result decode_by_byte(size_t len) {
+    enum studio_framing_state state = FRAMING_STATE_IDLE;
+    struct decode_result result = {0};
+
+    for (size_t i = 0; i < len; i++) {
+        result.calls++;
+        if (studio_framing_process_byte(&state, stream[i])) {
+            payload_by_byte[result.payload_len++] = stream[i];
+        }
+
+        if (state == FRAMING_STATE_EOF) {
+            result.frames++;
+        }
+    }
+
+    return result;
+}
+
+static struct decode_result decode_by_span(size_t len) {
+    enum studio_framing_state state = FRAMING_STATE_IDLE;
+    struct decode_result result = {0};
+    size_t read = 0;
+
+    while (read < len) {
+        size_t consumed;
+
+        result.calls++;
+        result.payload_len += studio_framing_decode(
+            &state, stream + read, len - read, payload_by_span + result.payload_len,
+            sizeof(payload_by_span) - result.payload_len, &consumed);
+        read += consumed;
+
+        if (state == FRAMING_STATE_EOF) {
+            result.frames++;
+        }
+    }
+
+    return result;
+}
+
+// Feeds the stream through the ring buffer and decodes it the way rpc_read_cb() does, starting
+// @p offset bytes into the ring so frames are split at different points of its wrap
+static struct decode_result decode_by_ring(size_t len, size_t offset) {
+    enum studio_framing_state state = FRAMING_STATE_IDLE;
+    struct decode_result result = {0};
+    size_t put = 0;
+
+    ring_buf_reset(&benchmark_ring);
+    ring_buf_put(&benchmark_ring, stream, offset);
+    ring_buf_get(&benchmark_ring, NULL, offset);
+
+    while (put < len || !ring_buf_is_empty(&benchmark_ring)) {
+        uint8_t *claimed;
+        size_t consumed;
+
+        put += ring_buf_put(&benchmark_ring, stream + put, len - put);
+
+        uint32_t claim_len = ring_buf_get_claim(&benchmark_ring, &claimed,
+                                                ring_buf_capacity_get(&benchmark_ring));
+
+        result.calls++;
+        result.payload_len += studio_framing_decode(
+            &state, claimed, claim_len, payload_by_ring + result.payload_len,
+            sizeof(payload_by_ring) - result.payload_len, &consumed);
+        ring_buf_get_finish(&benchmark_ring, consumed);
+
+        if (state == FRAMING_STATE_EOF) {
+            result.frames++;
+        }
+    }
+
+    return result;
+}
+
+static bool results_match(const struct decode_result *a, const uint8_t *a_payload,
+                          const struct decode_result *b, const uint8_t *b_payload) {
+    return a->frames == b->frames && a->payload_len == b->payload_len &&
+           memcmp(a_payload, b_payload, a->payload_len) == 0;
+}
+
+static uint64_t now_us(void) {
+#if IS_ENABLED(CONFIG_ARCH_POSIX)
+    // Simulated time stands still while the benchmark runs, so use the host clock instead
+    return native_rtc_gettime_us(RTC_CLOCK_PSEUDOHOSTREALTIME);
+#else
+    return k_cyc_to_us_floor64(k_cycle_get_32());
+#endif
+}
+
+static void log_timing(const char *decoder, uint64_t elapsed_us, size_t len) {
+    // Bytes per microsecond is MB/s
+    LOG_INF("%s decoder: %u MB/s", decoder,
+            (uint32_t)(BENCHMARK_ROUNDS * len / MAX(elapsed_us, 1)));
+}
+
+static int framing_benchmark_run(void) {
+    size_t len = build_stream();
+
+    struct decode_result by_byte = decode_by_byte(len);
+    struct decode_result by_span = decode_by_span(len);
+
+    LOG_INF("Decoded %d frames of %d bytes from %d bytes", by_byte.frames,
+            (int)by_byte.payload_len, (int)len);
+
+    if (results_match(&by_byte, payload_by_byte, &by_span, payload_by_span)) {
+        LOG_INF("Span decoder output matches");
+    } else {
+        LOG_ERR("Span decoder output differs: %d frames of %d bytes", by_span.frames,
+                (int)by_span.payload_len);
+    }
+
+    int ring_mismatches = 0;
+    size_t ring_size = ring_buf_capacity_get(&benchmark_ring);
+
+    for (size_t offset = 0; offset < ring_size; offset++) {
+        struct decode_result by_ring = decode_by_ring(len, offset);
+
+        if (!results_match(&by_byte, payload_by_byte, &by_ring, payload_by_ring)) {
+            LOG_ERR("Ring decoder output differs at offset %d: %d frames of %d bytes",
+                    (int)offset, by_ring.frames, (int)by_ring.payload_len);
+            ring_mismatches++;
+        }
+    }
+
+    if (ring_mismatches == 0) {
+        LOG_INF("Ring decoder output matches at all %d offsets", (int)ring_size);
+    }
+
+    LOG_INF("Decoder calls: %d per byte, %d per span", by_byte.calls, by_span.calls);
+
+    uint64_t start = now_us();
+    for (int r = 0; r < BENCHMARK_ROUNDS; r++) {
+        decode_by_byte(len);
+    }
+    log_timing("Per byte", now_us() - start, len);
+
+    start = now_us();
+    for (int r = 0; r < BENCHMARK_ROUNDS; r++) {
+        decode_by_span(len);
+    }
+    log_timing("Span", now_us() - start, len);
+
+    return 0;
+}
+
+SYS_INIT(framing_benchmark_run, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -25,13 +25,61 @@ LOG_MODULE_DECLARE(zmk_studio, CONFIG_ZMK_STUDIO_LOG_LEVEL);
 
 static bool handling_rx = false;
 
+// How long a write waits for the RPC thread to make room in the RX buffer
+#define RX_SPACE_TIMEOUT K_SECONDS(1)
+
 static atomic_t notify_size;
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+
+// Whether the client subscribed to notifications rather than indications
+static atomic_t streaming;
+
+static void refresh_notify_size(void);
+
+// Notifications queued but not sent yet
+static K_SEM_DEFINE(stream_window, CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING_WINDOW,
+                    CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING_WINDOW);
+
+static void request_fast_link(struct bt_conn *conn) {
+    int ret = bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    if (ret < 0 && ret != -EALREADY) {
+        LOG_WRN("Failed to request a longer data length while studio is active (%d)", ret);
+    }
+
+    ret = bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+    if (ret < 0 && ret != -EALREADY) {
+        LOG_WRN("Failed to request the 2M PHY while studio is active (%d)", ret);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+
 static void rpc_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value) {
     ARG_UNUSED(attr);
 
     bool notif_enabled = (value == BT_GATT_CCC_INDICATE);
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+    atomic_set(&streaming, value == BT_GATT_CCC_NOTIFY);
+    notif_enabled |= (value == BT_GATT_CCC_NOTIFY);
+
+    refresh_notify_size();
+
+    if (value == BT_GATT_CCC_NOTIFY) {
+        // Sent callbacks of a previous subscription may never have arrived
+        for (int i = 0; i < CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING_WINDOW; i++) {
+            k_sem_give(&stream_window);
+        }
+
+        struct bt_conn *conn = zmk_ble_active_profile_conn();
+        if (conn) {
+            request_fast_link(conn);
+            bt_conn_unref(conn);
+        }
+    }
+#endif
+
     LOG_INF("RPC Notifications %s", notif_enabled ? "enabled" : "disabled");
 
 #if CONFIG_ZMK_STUDIO_TRANSPORT_BLE_PREF_LATENCY < CONFIG_BT_PERIPHERAL_PREF_LATENCY
@@ -66,18 +114,22 @@ static ssize_t write_rpc_req(struct bt_conn *conn, const struct bt_gatt_attr *at
         return len;
     }
 
-    uint32_t copied = 0;
     struct ring_buf *rpc_buf = zmk_rpc_get_rx_buf();
-    while (copied < len) {
-        uint8_t *buffer;
-        uint32_t claim_len = ring_buf_put_claim(rpc_buf, &buffer, len - copied);
 
-        if (claim_len > 0) {
-            memcpy(buffer, ((uint8_t *)buf) + copied, claim_len);
-            copied += claim_len;
+    uint32_t copied = 0;
+    while (copied < len) {
+        uint32_t put = ring_buf_put(rpc_buf, ((uint8_t *)buf) + copied, len - copied);
+
+        copied += put;
+        if (put == 0) {
+            // The RPC thread may run at a lower priority than the Bluetooth RX thread, so sleep
+            // until it has made room rather than yielding
+            zmk_rpc_rx_notify();
+            if (zmk_rpc_rx_wait_for_space(RX_SPACE_TIMEOUT) < 0) {
+                LOG_WRN("RPC RX buffer still full, dropping %d bytes", len - copied);
+                break;
+            }
         }
-
-        ring_buf_put_finish(rpc_buf, claim_len);
     }
 
     zmk_rpc_rx_notify();
@@ -88,7 +140,9 @@ static ssize_t write_rpc_req(struct bt_conn *conn, const struct bt_gatt_attr *at
 BT_GATT_SERVICE_DEFINE(
     rpc_interface, BT_GATT_PRIMARY_SERVICE(BT_UUID_DECLARE_128(ZMK_STUDIO_BT_SERVICE_UUID)),
     BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_STUDIO_BT_RPC_CHRC_UUID),
-                           BT_GATT_CHRC_WRITE | BT_GATT_CHRC_READ | BT_GATT_CHRC_INDICATE,
+                           BT_GATT_CHRC_WRITE | BT_GATT_CHRC_READ | BT_GATT_CHRC_INDICATE |
+                               COND_CODE_1(IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING),
+                                           (BT_GATT_CHRC_NOTIFY), (0)),
                            BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT, read_rpc_resp,
                            write_rpc_req, NULL),
     BT_GATT_CCC(rpc_ccc_cfg_changed, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT));
@@ -100,6 +154,13 @@ static uint16_t get_notify_size_for_conn(struct bt_conn *conn) {
         notify_size = conn_info.le.data_len->tx_max_len;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+    // Notifications fill the whole ATT MTU and are split over several packets by the controller
+    if (conn && atomic_get(&streaming)) {
+        notify_size = bt_gatt_get_mtu(conn) - 3;
+    }
+#endif
+
     return notify_size;
 }
 
@@ -129,6 +190,36 @@ static struct bt_gatt_indicate_params rpc_indicate_params = {
     .attr = &rpc_interface.attrs[1],
 };
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+
+static void stream_sent(struct bt_conn *conn, void *user_data);
+
+static int stream_notify(struct bt_conn *conn, const uint8_t *data, uint16_t len) {
+    struct bt_gatt_notify_params params = {
+        .attr = &rpc_interface.attrs[1],
+        .data = data,
+        .len = len,
+        .func = stream_sent,
+    };
+
+    return bt_gatt_notify_cb(conn, &params);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+
+static int send_rpc_resp(struct bt_conn *conn, const uint8_t *data, uint16_t len) {
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+    if (atomic_get(&streaming)) {
+        return stream_notify(conn, data, len);
+    }
+#endif
+
+    rpc_indicate_params.data = data;
+    rpc_indicate_params.len = len;
+
+    return bt_gatt_indicate(conn, &rpc_indicate_params);
+}
+
 static void notif_rpc_tx_cb(struct k_work *work) {
     struct bt_conn *conn = zmk_ble_active_profile_conn();
     struct ring_buf *tx_buf = zmk_rpc_get_tx_buf();
@@ -143,6 +234,16 @@ static void notif_rpc_tx_cb(struct k_work *work) {
     uint8_t notify_bytes[notify_size];
 
     while (ring_buf_size_get(tx_buf) > 0) {
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+        bool windowed = atomic_get(&streaming);
+
+        // The sent callbacks run on the system work queue as well, so rather than waiting for the
+        // window to open here, leave the rest queued and let the next callback resubmit this work.
+        if (windowed && k_sem_take(&stream_window, K_NO_WAIT) < 0) {
+            break;
+        }
+#endif
+
         uint16_t added = 0;
         while (added < notify_size && ring_buf_size_get(tx_buf) > 0) {
             uint8_t *buf;
@@ -154,12 +255,10 @@ static void notif_rpc_tx_cb(struct k_work *work) {
             ring_buf_get_finish(tx_buf, len);
         }
 
-        rpc_indicate_params.data = notify_bytes;
-        rpc_indicate_params.len = added;
-
+        int err;
         int notify_attempts = 5;
         do {
-            int err = bt_gatt_indicate(conn, &rpc_indicate_params);
+            err = send_rpc_resp(conn, notify_bytes, added);
             if (err >= 0) {
                 break;
             }
@@ -167,6 +266,12 @@ static void notif_rpc_tx_cb(struct k_work *work) {
             LOG_WRN("Failed to notify the response %d", err);
             k_sleep(K_MSEC(200));
         } while (notify_attempts-- > 0);
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+        if (windowed && err < 0) {
+            k_sem_give(&stream_window);
+        }
+#endif
     }
 
     bt_conn_unref(conn);
@@ -174,6 +279,15 @@ static void notif_rpc_tx_cb(struct k_work *work) {
 
 static K_WORK_DEFINE(notify_tx_work, notif_rpc_tx_cb);
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+
+static void stream_sent(struct bt_conn *conn, void *user_data) {
+    k_sem_give(&stream_window);
+    k_work_submit(&notify_tx_work);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_BLE_STREAMING)
+
 struct gatt_write_state {
     size_t pending_notify;
 };
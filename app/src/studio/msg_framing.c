@@ -7,8 +7,15 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <string.h>
+
 #include "msg_framing.h"
 
+BUILD_ASSERT(FRAMING_ESC == FRAMING_SOF + 1 && FRAMING_EOF == FRAMING_SOF + 2,
+             "The framing bytes are matched as one range");
+
+#define IS_FRAMING_BYTE(c) ((uint8_t)((c)-FRAMING_SOF) <= FRAMING_EOF - FRAMING_SOF)
+
 static bool process_byte_err_state(enum studio_framing_state *rpc_framing_state, uint8_t c) {
     switch (c) {
     case FRAMING_EOF:
@@ -77,4 +84,46 @@ bool studio_framing_process_byte(enum studio_framing_state *rpc_framing_state, u
         LOG_ERR("Unsupported framing state: %d", *rpc_framing_state);
         return false;
     }
-}
\ No newline at end of file
+}
+
+size_t studio_framing_decode(enum studio_framing_state *frame_state, const uint8_t *in,
+                             size_t in_len, uint8_t *out, size_t out_len, size_t *consumed) {
+    size_t read = 0;
+    size_t written = 0;
+
+    while (read < in_len) {
+        uint8_t c = in[read];
+        bool data = *frame_state == FRAMING_STATE_ESCAPED ||
+                    (*frame_state == FRAMING_STATE_AWAITING_DATA && !IS_FRAMING_BYTE(c));
+
+        if (data && written == out_len) {
+            break;
+        }
+
+        if (data && *frame_state == FRAMING_STATE_AWAITING_DATA) {
+            size_t run = 1;
+            size_t max_run = MIN(in_len - read, out_len - written);
+
+            while (run < max_run && !IS_FRAMING_BYTE(in[read + run])) {
+                run++;
+            }
+
+            memmove(out + written, in + read, run);
+            read += run;
+            written += run;
+            continue;
+        }
+
+        read++;
+        if (studio_framing_process_byte(frame_state, c)) {
+            out[written++] = c;
+        }
+
+        if (*frame_state == FRAMING_STATE_EOF) {
+            break;
+        }
+    }
+
+    *consumed = read;
+    return written;
+}
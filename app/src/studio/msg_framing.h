@@ -29,3 +29,16 @@ enum studio_framing_state {
  * has been updated.
  */
 bool studio_framing_process_byte(enum studio_framing_state *frame_state, uint8_t data);
+
+/**
+ * @brief Decode a span of received bytes, unescaping the frame payload bytes into @p out.
+ *
+ * Runs of plain payload bytes are copied at once instead of going through the per byte state
+ * machine. @p out may be the same as @p in to decode in place. Decoding stops once a frame end has
+ * been consumed, leaving @p frame_state at FRAMING_STATE_EOF, or once @p out is full.
+ *
+ * @param consumed Set to the number of bytes of @p in that were consumed.
+ * @retval The number of payload bytes written to @p out.
+ */
+size_t studio_framing_decode(enum studio_framing_state *frame_state, const uint8_t *in,
+                             size_t in_len, uint8_t *out, size_t out_len, size_t *consumed);
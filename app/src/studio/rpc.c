@@ -72,6 +72,7 @@ static zmk_studio_Response handle_request(const zmk_studio_Request *req) {
 RING_BUF_DECLARE(rpc_rx_buf, CONFIG_ZMK_STUDIO_RPC_RX_BUF_SIZE);
 
 static K_SEM_DEFINE(rpc_rx_sem, 0, 1);
+static K_SEM_DEFINE(rpc_rx_space_sem, 0, 1);
 
 static enum studio_framing_state rpc_framing_state;
 
@@ -82,24 +83,50 @@ struct ring_buf *zmk_rpc_get_rx_buf(void) { return &rpc_rx_buf; }
 
 void zmk_rpc_rx_notify(void) { k_sem_give(&rpc_rx_sem); }
 
+int zmk_rpc_rx_wait_for_space(k_timeout_t timeout) {
+    return k_sem_take(&rpc_rx_space_sem, timeout);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_LOG_BUF_USAGE)
+
+static void log_buf_usage(struct ring_buf *buf, const char *name, uint32_t *peak) {
+    uint32_t used = ring_buf_size_get(buf);
+
+    if (used > *peak) {
+        *peak = used;
+        LOG_INF("%s buffer peak usage: %d of %d bytes", name, used, ring_buf_capacity_get(buf));
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_LOG_BUF_USAGE)
+
 static bool rpc_read_cb(pb_istream_t *stream, uint8_t *buf, size_t count) {
-    uint32_t write_offset = 0;
+    size_t write_offset = 0;
 
     do {
         uint8_t *buffer;
-        uint32_t len = ring_buf_get_claim(&rpc_rx_buf, &buffer, count);
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_LOG_BUF_USAGE)
+        static uint32_t rx_peak;
+        log_buf_usage(&rpc_rx_buf, "RX", &rx_peak);
+#endif
+
+        uint32_t len = ring_buf_get_claim(&rpc_rx_buf, &buffer, ring_buf_capacity_get(&rpc_rx_buf));
+        size_t consumed = 0;
 
         if (len > 0) {
-            for (int i = 0; i < len; i++) {
-                if (studio_framing_process_byte(&rpc_framing_state, buffer[i])) {
-                    buf[write_offset++] = buffer[i];
-                }
-            }
+            write_offset += studio_framing_decode(&rpc_framing_state, buffer, len,
+                                                  buf + write_offset, count - write_offset,
+                                                  &consumed);
         } else {
             k_sem_take(&rpc_rx_sem, K_FOREVER);
         }
 
-        ring_buf_get_finish(&rpc_rx_buf, len);
+        // Bytes after the end of the frame are left for the next request
+        ring_buf_get_finish(&rpc_rx_buf, consumed);
+        if (consumed > 0) {
+            k_sem_give(&rpc_rx_space_sem);
+        }
     } while (write_offset < count && rpc_framing_state != FRAMING_STATE_EOF);
 
     if (rpc_framing_state == FRAMING_STATE_EOF) {
@@ -162,6 +189,10 @@ static bool rpc_tx_buffer_write(pb_ostream_t *stream, const uint8_t *buf, size_t
         }
 
         ring_buf_put_finish(&rpc_tx_buf, write_idx);
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_LOG_BUF_USAGE)
+        static uint32_t tx_peak;
+        log_buf_usage(&rpc_tx_buf, "TX", &tx_peak);
+#endif
 
         written += (write_idx - escapes_written);
 
@@ -8,11 +8,16 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/uart.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/ring_buffer.h>
 
+#include <string.h>
+
 #include <zephyr/logging/log.h>
 #include <zmk/studio/rpc.h>
 
+#include "msg_framing.h"
+
 LOG_MODULE_DECLARE(zmk_studio, CONFIG_ZMK_STUDIO_LOG_LEVEL);
 
 /* change this to any other UART peripheral if desired */
@@ -20,10 +25,100 @@ LOG_MODULE_DECLARE(zmk_studio, CONFIG_ZMK_STUDIO_LOG_LEVEL);
 
 static const struct device *const uart_dev = DEVICE_DT_GET(UART_DEVICE_NODE);
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+
+#define ASYNC_RX_TIMEOUT_US 1000
+
+static uint8_t async_rx_bufs[2][CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC_RX_BUF_SIZE];
+static uint8_t async_rx_next;
+static bool async_rx_enabled;
+
+// Length of the TX buffer claim being transmitted, or 0 when idle
+static atomic_t async_tx_len;
+
+static void async_tx_start(void) {
+    struct ring_buf *tx_buf = zmk_rpc_get_tx_buf();
+    uint8_t *buf;
+
+    // Only the first caller claims, the rest is sent once that transfer is done
+    if (!atomic_cas(&async_tx_len, 0, -1)) {
+        return;
+    }
+
+    uint32_t claim_len = ring_buf_get_claim(tx_buf, &buf, ring_buf_capacity_get(tx_buf));
+    if (claim_len == 0) {
+        atomic_set(&async_tx_len, 0);
+        return;
+    }
+
+    atomic_set(&async_tx_len, claim_len);
+
+    // Sent straight out of the ring buffer, it is only released once the transfer is done
+    int ret = uart_tx(uart_dev, buf, claim_len, SYS_FOREVER_US);
+    if (ret < 0) {
+        LOG_WRN("Failed to start sending the RPC response (%d)", ret);
+        ring_buf_get_finish(tx_buf, 0);
+        atomic_set(&async_tx_len, 0);
+    }
+}
+
+static void async_rx_received(const uint8_t *data, size_t len) {
+    struct ring_buf *rx_buf = zmk_rpc_get_rx_buf();
+
+    uint32_t put = ring_buf_put(rx_buf, data, len);
+    if (put < len) {
+        LOG_ERR("Dropping %d incoming RPC bytes, insufficient room in the RX buffer. Bump "
+                "CONFIG_ZMK_STUDIO_RPC_RX_BUF_SIZE.",
+                len - put);
+    }
+
+    // Only wake the RPC thread once a frame may be complete, or the buffer is filling up
+    if (memchr(data, FRAMING_EOF, len) ||
+        ring_buf_space_get(rx_buf) < ring_buf_capacity_get(rx_buf) / 2) {
+        zmk_rpc_rx_notify();
+    }
+}
+
+static int async_rx_enable(void) {
+    async_rx_next = 1;
+    return uart_rx_enable(uart_dev, async_rx_bufs[0], sizeof(async_rx_bufs[0]),
+                          ASYNC_RX_TIMEOUT_US);
+}
+
+static void async_uart_cb(const struct device *dev, struct uart_event *evt, void *user_data) {
+    switch (evt->type) {
+    case UART_TX_DONE:
+    case UART_TX_ABORTED:
+        ring_buf_get_finish(zmk_rpc_get_tx_buf(), atomic_get(&async_tx_len));
+        atomic_set(&async_tx_len, 0);
+        async_tx_start();
+        break;
+    case UART_RX_RDY:
+        async_rx_received(evt->data.rx.buf + evt->data.rx.offset, evt->data.rx.len);
+        break;
+    case UART_RX_BUF_REQUEST:
+        uart_rx_buf_rsp(dev, async_rx_bufs[async_rx_next], sizeof(async_rx_bufs[0]));
+        async_rx_next = !async_rx_next;
+        break;
+    case UART_RX_DISABLED:
+        // Errors such as a break on the line stop reception
+        if (async_rx_enabled) {
+            async_rx_enable();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+
 static void tx_notify(struct ring_buf *tx_ring_buf, size_t written, bool msg_done,
                       void *user_data) {
     if (msg_done || (ring_buf_size_get(tx_ring_buf) > (ring_buf_capacity_get(tx_ring_buf) / 2))) {
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+        async_tx_start();
+#elif IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
         uart_irq_tx_enable(uart_dev);
 #else
         struct ring_buf *tx_buf = zmk_rpc_get_tx_buf();
@@ -40,7 +135,7 @@ static void tx_notify(struct ring_buf *tx_ring_buf, size_t written, bool msg_don
     }
 }
 
-#if !IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if !IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN) && !IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
 
 static void uart_rx_main(void) {
     for (;;) {
@@ -70,7 +165,10 @@ K_THREAD_DEFINE(uart_transport_read_thread, CONFIG_ZMK_STUDIO_TRANSPORT_UART_RX_
 #endif
 
 static int start_rx() {
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+    async_rx_enabled = true;
+    return async_rx_enable();
+#elif IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
     uart_irq_rx_enable(uart_dev);
 #else
     k_thread_resume(uart_transport_read_thread);
@@ -79,7 +177,10 @@ static int start_rx() {
 }
 
 static int stop_rx(void) {
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+    async_rx_enabled = false;
+    uart_rx_disable(uart_dev);
+#elif IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
     uart_irq_rx_disable(uart_dev);
 #else
     k_thread_suspend(uart_transport_read_thread);
@@ -89,7 +190,7 @@ static int stop_rx(void) {
 
 ZMK_RPC_TRANSPORT(uart, ZMK_TRANSPORT_USB, start_rx, stop_rx, NULL, tx_notify);
 
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN) && !IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
 
 /*
  * Read characters from UART until line end is detected. Afterwards push the
@@ -148,7 +249,13 @@ static int uart_rpc_interface_init(void) {
         return -ENODEV;
     }
 
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+    int ret = uart_callback_set(uart_dev, async_uart_cb, NULL);
+    if (ret < 0) {
+        LOG_ERR("Failed to set the async UART callback (%d)", ret);
+        return ret;
+    }
+#elif IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
     /* configure interrupt and callback to receive data */
     int ret = uart_irq_callback_user_data_set(uart_dev, serial_cb, NULL);
 
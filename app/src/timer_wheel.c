@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/sys/util.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/timer_wheel.h>
+
+/*
+ * Hierarchical timer wheel with a resolution of one millisecond. Level 0 holds timers due within
+ * the next 64 ms in one slot per millisecond. Each following level covers 64 times the span of
+ * the previous one, and its slots are cascaded down into the lower levels as the wheel reaches
+ * them. Timers further out than the last level are parked in its farthest slot and re-sorted
+ * each time that slot is cascaded.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4
+
+#define LEVEL_SHIFT(level) ((level) * WHEEL_BITS)
+#define LEVEL_SPAN(level) (1LL << LEVEL_SHIFT((level) + 1))
+
+static sys_dlist_t slots[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t occupied[WHEEL_LEVELS];
+static size_t timer_count;
+
+// Millisecond of uptime the wheel is at. Timers due at or before it expire on the next pass.
+static int64_t wheel_time;
+
+// Expired timers whose handlers haven't run yet
+static sys_dlist_t expired = SYS_DLIST_STATIC_INIT(&expired);
+static struct zmk_timer *running;
+static k_tid_t running_thread;
+
+// Time the kernel timeout driving the wheel is set for
+static int64_t wakeup_at = INT64_MAX;
+
+static struct k_spinlock lock;
+
+static void wheel_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(wheel_work, wheel_work_handler);
+
+static inline sys_dlist_t *wheel_slot(uint8_t level, uint8_t slot) {
+    sys_dlist_t *list = &slots[level][slot];
+
+    // Zeroed static lists are lazily turned into empty lists
+    if (list->head == NULL) {
+        sys_dlist_init(list);
+    }
+
+    return list;
+}
+
+static void wheel_insert(struct zmk_timer *timer) {
+    int64_t deadline = MAX(timer->deadline, wheel_time);
+    int64_t delta = deadline - wheel_time;
+    uint8_t level = 0;
+
+    while (level < WHEEL_LEVELS - 1 && delta >= LEVEL_SPAN(level)) {
+        level++;
+    }
+
+    if (delta >= LEVEL_SPAN(level)) {
+        deadline = wheel_time + LEVEL_SPAN(level) - 1;
+    }
+
+    uint8_t slot = (deadline >> LEVEL_SHIFT(level)) & WHEEL_MASK;
+
+    timer->slot = level * WHEEL_SLOTS + slot;
+    sys_dlist_append(wheel_slot(level, slot), &timer->node);
+    occupied[level] |= BIT64(slot);
+    timer_count++;
+}
+
+static void wheel_remove(struct zmk_timer *timer) {
+    sys_dlist_remove(&timer->node);
+
+    if (timer->slot < 0) {
+        return;
+    }
+
+    uint8_t level = timer->slot / WHEEL_SLOTS;
+    uint8_t slot = timer->slot % WHEEL_SLOTS;
+
+    if (sys_dlist_is_empty(wheel_slot(level, slot))) {
+        occupied[level] &= ~BIT64(slot);
+    }
+    timer_count--;
+}
+
+static void wheel_cascade(uint8_t level) {
+    uint8_t slot = (wheel_time >> LEVEL_SHIFT(level)) & WHEEL_MASK;
+    sys_dlist_t *list = wheel_slot(level, slot);
+    sys_dlist_t cascading;
+    sys_dnode_t *node;
+
+    if (!(occupied[level] & BIT64(slot))) {
+        return;
+    }
+
+    // Parked timers may go straight back into this slot, so take them all out first
+    sys_dlist_init(&cascading);
+    while ((node = sys_dlist_get(list)) != NULL) {
+        sys_dlist_append(&cascading, node);
+        timer_count--;
+    }
+    occupied[level] &= ~BIT64(slot);
+
+    while ((node = sys_dlist_get(&cascading)) != NULL) {
+        wheel_insert(CONTAINER_OF(node, struct zmk_timer, node));
+    }
+}
+
+// Moves the wheel to @p time, cascading the higher levels when it reaches their slot boundaries
+static void wheel_set_time(int64_t time) {
+    wheel_time = time;
+
+    for (uint8_t level = 1; level < WHEEL_LEVELS; level++) {
+        if (time & (BIT64(LEVEL_SHIFT(level)) - 1)) {
+            break;
+        }
+
+        wheel_cascade(level);
+    }
+}
+
+// Next time the wheel needs to expire timers or cascade an occupied slot
+static int64_t wheel_next_expiry(void) {
+    int64_t next = INT64_MAX;
+
+    for (uint8_t level = 0; level < WHEEL_LEVELS; level++) {
+        if (occupied[level] == 0) {
+            continue;
+        }
+
+        int64_t position = wheel_time >> LEVEL_SHIFT(level);
+        uint8_t slot = position & WHEEL_MASK;
+
+        // Rotate so the slot of the current position is bit 0
+        uint64_t ahead = occupied[level] >> slot;
+        if (slot > 0) {
+            ahead |= occupied[level] << (WHEEL_SLOTS - slot);
+        }
+
+        uint8_t distance = u64_count_trailing_zeros(ahead);
+        if (level > 0 && distance == 0) {
+            // Higher level slots are cascaded as soon as the wheel reaches them, so a timer in
+            // the slot of the current position is parked a full turn away
+            ahead &= ~BIT64(0);
+            distance = ahead == 0 ? WHEEL_SLOTS : u64_count_trailing_zeros(ahead);
+        }
+
+        next = MIN(next, (position + distance) << LEVEL_SHIFT(level));
+    }
+
+    return next;
+}
+
+static void wheel_advance(int64_t now) {
+    while (timer_count > 0) {
+        int64_t next = wheel_next_expiry();
+        if (next > now) {
+            break;
+        }
+
+        if (next > wheel_time) {
+            wheel_set_time(next);
+            continue;
+        }
+
+        // Everything due at the same millisecond expires in one batch
+        uint8_t slot = wheel_time & WHEEL_MASK;
+        sys_dlist_t *list = wheel_slot(0, slot);
+        sys_dnode_t *node;
+        while ((node = sys_dlist_get(list)) != NULL) {
+            CONTAINER_OF(node, struct zmk_timer, node)->slot = -1;
+            sys_dlist_append(&expired, node);
+            timer_count--;
+        }
+        occupied[0] &= ~BIT64(slot);
+
+        // Stay at the current millisecond, so timers scheduled for it afterwards expire on the
+        // next pass rather than a millisecond late
+        if (wheel_time >= now) {
+            break;
+        }
+
+        wheel_set_time(wheel_time + 1);
+    }
+
+    // Skipped slot boundaries had nothing to cascade
+    if (wheel_time < now) {
+        wheel_set_time(now);
+    }
+}
+
+// Must be called with the lock held
+static void wheel_update_wakeup(void) {
+    int64_t next = sys_dlist_is_empty(&expired) ? wheel_next_expiry() : k_uptime_get();
+
+    if (next >= wakeup_at) {
+        return;
+    }
+
+    wakeup_at = next;
+    k_work_reschedule(&wheel_work, K_TIMEOUT_ABS_MS(next));
+}
+
+static void wheel_work_handler(struct k_work *work) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    wakeup_at = INT64_MAX;
+    wheel_advance(k_uptime_get());
+
+    sys_dnode_t *node;
+    while ((node = sys_dlist_get(&expired)) != NULL) {
+        struct zmk_timer *timer = CONTAINER_OF(node, struct zmk_timer, node);
+
+        timer->pending = false;
+        running = timer;
+        running_thread = k_current_get();
+        k_spin_unlock(&lock, key);
+
+        timer->handler(timer);
+
+        key = k_spin_lock(&lock);
+        running = NULL;
+    }
+
+    wheel_update_wakeup();
+    k_spin_unlock(&lock, key);
+}
+
+void zmk_timer_init(struct zmk_timer *timer, zmk_timer_handler_t handler) {
+    *timer = (struct zmk_timer)ZMK_TIMER_INITIALIZER(handler);
+}
+
+void zmk_timer_schedule_at(struct zmk_timer *timer, int64_t deadline) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (timer->pending) {
+        wheel_remove(timer);
+    }
+
+    if (timer_count == 0) {
+        wheel_time = MAX(wheel_time, k_uptime_get());
+    }
+
+    timer->deadline = deadline;
+    timer->pending = true;
+    wheel_insert(timer);
+    wheel_update_wakeup();
+
+    k_spin_unlock(&lock, key);
+}
+
+void zmk_timer_schedule(struct zmk_timer *timer, int32_t delay_ms) {
+    zmk_timer_schedule_at(timer, k_uptime_get() + MAX(delay_ms, 0));
+}
+
+int zmk_timer_cancel(struct zmk_timer *timer) {
+    int ret = 0;
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (timer->pending) {
+        // The kernel timeout is left alone, waking up with nothing to do is cheaper
+        wheel_remove(timer);
+        timer->pending = false;
+    } else if (timer == running && running_thread != k_current_get()) {
+        ret = -EINPROGRESS;
+    }
+
+    k_spin_unlock(&lock, key);
+    return ret;
+}
+
+bool zmk_timer_is_pending(const struct zmk_timer *timer) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    bool pending = timer->pending || timer == running;
+    k_spin_unlock(&lock, key);
+
+    return pending;
+}
@@ -8,6 +8,8 @@
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
 
+#include <stdlib.h>
+
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -18,64 +20,106 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/wpm.h>
 
-#define WPM_UPDATE_INTERVAL_SECONDS 1
-#define WPM_RESET_INTERVAL_SECONDS 5
+#define WPM_BUCKETS (CONFIG_ZMK_WPM_WINDOW_MS / CONFIG_ZMK_WPM_RESOLUTION_MS)
+
+BUILD_ASSERT(CONFIG_ZMK_WPM_WINDOW_MS % CONFIG_ZMK_WPM_RESOLUTION_MS == 0,
+             "CONFIG_ZMK_WPM_RESOLUTION_MS must evenly divide CONFIG_ZMK_WPM_WINDOW_MS");
+BUILD_ASSERT(WPM_BUCKETS > 0 && WPM_BUCKETS <= UINT8_MAX,
+             "The WPM window must be between 1 and 255 updates long");
 
 // See https://en.wikipedia.org/wiki/Words_per_minute
 // "Since the length or duration of words is clearly variable, for the purpose of measurement of
 // text entry, the definition of each "word" is often standardized to be five characters or
 // keystrokes long in English"
-#define CHARS_PER_WORD 5.0
+#define CHARS_PER_WORD 5
+
+// Keys per millisecond to words per minute
+#define WPM_SCALE (MSEC_PER_SEC * 60 / CHARS_PER_WORD)
 
 static uint8_t wpm_state = -1;
-static uint8_t last_wpm_state;
-static uint8_t wpm_update_counter;
-static uint32_t key_pressed_count;
+
+// Key presses in each update interval of the window, oldest first starting at bucket_idx + 1
+static uint16_t buckets[WPM_BUCKETS];
+static uint8_t bucket_idx;
+static uint32_t window_count;
+// Intervals since typing started, so a short burst isn't averaged over the whole window
+static uint8_t active_buckets;
+static bool wpm_running;
 
 int zmk_wpm_get_state(void) { return wpm_state; }
 
-int wpm_event_listener(const zmk_event_t *eh) {
-    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
-    if (ev) {
-        // count only key up events
-        if (!ev->state) {
-            key_pressed_count++;
-            LOG_DBG("key_pressed_count %d keycode %d", key_pressed_count, ev->keycode);
-        }
+void wpm_work_handler(struct k_work *work);
+
+K_WORK_DEFINE(wpm_work, wpm_work_handler);
+
+static void wpm_expiry_function(struct k_timer *_timer) { k_work_submit(&wpm_work); }
+
+K_TIMER_DEFINE(wpm_timer, wpm_expiry_function, NULL);
+
+static bool wpm_changed(uint8_t wpm) {
+    if (wpm == wpm_state) {
+        return false;
     }
-    return 0;
+
+    return wpm == 0 || abs(wpm - wpm_state) >= CONFIG_ZMK_WPM_MIN_CHANGE;
 }
 
 void wpm_work_handler(struct k_work *work) {
-    wpm_update_counter++;
-    wpm_state = (key_pressed_count / CHARS_PER_WORD) /
-                (wpm_update_counter * WPM_UPDATE_INTERVAL_SECONDS / 60.0);
+    if (active_buckets < WPM_BUCKETS) {
+        active_buckets++;
+    }
 
-    if (last_wpm_state != wpm_state) {
-        LOG_DBG("Raised WPM state changed %d wpm_update_counter %d", wpm_state, wpm_update_counter);
+    uint32_t window_ms = active_buckets * CONFIG_ZMK_WPM_RESOLUTION_MS;
+    uint8_t wpm = MIN(window_count * WPM_SCALE / window_ms, UINT8_MAX);
 
-        raise_zmk_wpm_state_changed((struct zmk_wpm_state_changed){.state = wpm_state});
+    if (wpm_changed(wpm)) {
+        LOG_DBG("Raised WPM state changed %d window %d ms", wpm, window_ms);
 
-        last_wpm_state = wpm_state;
+        wpm_state = wpm;
+        raise_zmk_wpm_state_changed((struct zmk_wpm_state_changed){.state = wpm_state});
     }
 
-    if (wpm_update_counter >= WPM_RESET_INTERVAL_SECONDS) {
-        wpm_update_counter = 0;
-        key_pressed_count = 0;
+    // Slide the window, dropping the oldest interval
+    bucket_idx = (bucket_idx + 1) % WPM_BUCKETS;
+    window_count -= buckets[bucket_idx];
+    buckets[bucket_idx] = 0;
+
+    // Nothing left to count down, sleep until the next key press
+    if (window_count == 0 && wpm_state == 0) {
+        k_timer_stop(&wpm_timer);
+        wpm_running = false;
     }
 }
 
-K_WORK_DEFINE(wpm_work, wpm_work_handler);
+static void wpm_start(void) {
+    if (wpm_running) {
+        return;
+    }
 
-void wpm_expiry_function(struct k_timer *_timer) { k_work_submit(&wpm_work); }
+    wpm_running = true;
+    active_buckets = 0;
+    k_timer_start(&wpm_timer, K_MSEC(CONFIG_ZMK_WPM_RESOLUTION_MS),
+                  K_MSEC(CONFIG_ZMK_WPM_RESOLUTION_MS));
+}
 
-K_TIMER_DEFINE(wpm_timer, wpm_expiry_function, NULL);
+int wpm_event_listener(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    if (ev) {
+        // count only key up events
+        if (!ev->state) {
+            if (buckets[bucket_idx] < UINT16_MAX) {
+                buckets[bucket_idx]++;
+                window_count++;
+            }
+            LOG_DBG("key_pressed_count %d keycode %d", window_count, ev->keycode);
+            wpm_start();
+        }
+    }
+    return 0;
+}
 
 static int wpm_init(void) {
     wpm_state = 0;
-    wpm_update_counter = 0;
-    k_timer_start(&wpm_timer, K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS),
-                  K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS));
     return 0;
 }
 